@@ -0,0 +1,8 @@
+// Per-frame constants, shared by every program (FrameConstants in engine/uniforms.h)
+layout (std140) uniform FrameConstants
+{
+    mat4 projection;
+    vec2 screenSize;
+    float time;
+    float deltaTime;
+};
@@ -1,27 +1,33 @@
 #version 330 core
 
+// Variants: TEXT, ALPHA_TEST, SDF (ShaderFeature in engine/shader.h)
+
 in vec2 vUV;
 in vec4 vColor;
 
 uniform sampler2D atlasTexture;
-uniform bool isText;
 
 out vec4 FragColor;
 
 void main()
 {
-    if (isText)
-    {
-        // Font atlas is GL_RED
-        float alpha = texture(atlasTexture, vUV).r;
-        FragColor = vec4(vColor.rgb, vColor.a * alpha);
-    }
-    else
-    {
-        // Normal sprite texture (RGBA)
-        vec4 texColor = texture(atlasTexture, vUV);
-        if (texColor.a < 0.1)
-            discard;
-        FragColor = texColor * vColor;
-    }
-}
\ No newline at end of file
+    // Output is premultiplied alpha; vertex colors are straight alpha
+    vec4 tint = vec4(vColor.rgb * vColor.a, vColor.a);
+#if defined(TEXT)
+    // Font atlas is GL_RED coverage
+    FragColor = tint * texture(atlasTexture, vUV).r;
+#elif defined(SDF)
+    // Distance field atlas: 0.5 is the edge, antialiased over about a pixel
+    float distance = texture(atlasTexture, vUV).r;
+    float width = fwidth(distance);
+    FragColor = tint * smoothstep(0.5 - width, 0.5 + width, distance);
+#else
+    // Sprite textures are premultiplied RGBA
+    vec4 texColor = texture(atlasTexture, vUV);
+#ifdef ALPHA_TEST
+    if (texColor.a < 0.1)
+        discard;
+#endif
+    FragColor = texColor * tint;
+#endif
+}
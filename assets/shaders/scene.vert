@@ -4,7 +4,7 @@ layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec2 aUV;
 layout (location = 2) in vec4 aColor;
 
-uniform mat4 projection;
+#include "frame.glsl"
 
 out vec2 vUV;
 out vec4 vColor;
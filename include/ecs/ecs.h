@@ -28,6 +28,7 @@ public:
     template<typename T>
     void AddComponent(Entity entity, const T& component)
     {
+        MemoryTagScope tag(MEM_ECS);
         GetOrCreateStore<T>()->Insert(entity, component);
     }
 
@@ -50,7 +51,7 @@ public:
     }
 
     template<typename T>
-    std::unordered_map<Entity, T>& GetAllComponents()
+    ComponentMap<T>& GetAllComponents()
     {
         return GetOrCreateStore<T>()->GetAll();
     }
@@ -69,6 +70,7 @@ private:
         auto it = componentStores.find(type);
         if (it == componentStores.end())
         {
+            MemoryTagScope tag(MEM_ECS);
             auto store = std::make_unique<ComponentArray<T>>();
             ComponentArray<T>* ptr = store.get();
             componentStores[type] = std::move(store);
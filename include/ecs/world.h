@@ -1,5 +1,6 @@
 #pragma once
 #include <engine/utils.h>
+#include <engine/memory.h>
 #include <unordered_map>
 #include <vector>
 #include <memory>
@@ -8,6 +9,12 @@
 
 using Entity = u32;
 
+// Map nodes come from a per-size pool instead of new/delete, so spawning and
+// despawning short-lived entities doesn't churn the general heap
+template <typename T>
+using ComponentMap = std::unordered_map<Entity, T, std::hash<Entity>, std::equal_to<Entity>,
+                                        PoolStlAllocator<std::pair<const Entity, T>>>;
+
 // ------------------------------------------------------------
 // Base interface ONLY for storage polymorphism (not components)
 // ------------------------------------------------------------
@@ -42,11 +49,11 @@ public:
         return nullptr;
     }
 
-    std::unordered_map<Entity, T>& GetAll()
+    ComponentMap<T>& GetAll()
     {
         return components;
     }
 
 private:
-    std::unordered_map<Entity, T> components;
+    ComponentMap<T> components;
 };
\ No newline at end of file
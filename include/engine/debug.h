@@ -0,0 +1,6 @@
+#pragma once
+#include <engine/utils.h>
+
+// Per-tag live/peak bytes and allocations of the last frame, drawn with
+// RenderText starting at (x, y) and going down.
+void DrawMemoryOverlay(float x, float y, float scale);
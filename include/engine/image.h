@@ -0,0 +1,78 @@
+#pragma once
+#include <engine/utils.h>
+
+// ============================
+// CPU image helpers
+// ============================
+// Shared by the runtime texture loader and the offline cooker (tools/texcook),
+// so no GL in here. Pixels are tightly packed RGBA8.
+#define IMAGE_MAX_LEVELS 16
+
+i32 MipLevelCount(i32 width, i32 height);
+i32 MipSize(i32 size, i32 level);
+
+void PremultiplyAlpha(u8* pixels, size_t pixelCount);
+
+// 2x2 box filter into a (srcW/2, srcH/2) image, odd edges repeat their last texel
+void DownsampleRGBA8(const u8* src, i32 srcW, i32 srcH, u8* dst);
+
+// ============================
+// Block compression
+// ============================
+// BC1 (8 bytes per 4x4 block, 1-bit alpha) and BC3 (16 bytes, BC1 color plus
+// interpolated alpha). Endpoints come from the block's color bounding box,
+// which is fast and good enough for sprites; edge blocks repeat edge texels.
+#define BC1_BLOCK_BYTES 8
+#define BC3_BLOCK_BYTES 16
+
+size_t BlockCompressedSize(i32 width, i32 height, u32 blockBytes);
+void EncodeBC1(const u8* pixels, i32 width, i32 height, u8* dst);
+void EncodeBC3(const u8* pixels, i32 width, i32 height, u8* dst);
+
+// ============================
+// Cooked texture (.ctex)
+// ============================
+// Layout:
+//   CtexHeader
+//   level data, largest first, each starting on a CTEX_ALIGNMENT boundary
+//
+// Pixel data is ready for glTexStorage2D / glTex(Compressed)SubImage2D as
+// is: premultiplied alpha, every mip level present, no decoding at load.
+#define CTEX_MAGIC 0x58455443u // "CTEX"
+#define CTEX_VERSION 1
+#define CTEX_ALIGNMENT 16
+
+enum CtexFormat : u32 {
+    CTEX_FORMAT_RGBA8 = 0,
+    CTEX_FORMAT_BC1 = 1,
+    CTEX_FORMAT_BC3 = 2,
+};
+
+enum CtexFlags : u32 {
+    CTEX_FLAG_PREMULTIPLIED = 1 << 0,
+};
+
+struct CtexLevel {
+    u64 offset; // from the start of the file
+    u64 size;
+};
+
+struct CtexHeader {
+    u32 magic;
+    u32 version;
+    u32 format;
+    u32 flags;
+    u32 width;
+    u32 height;
+    u32 levelCount;
+    u32 reserved;
+    CtexLevel levels[IMAGE_MAX_LEVELS];
+};
+
+static_assert(sizeof(CtexHeader) == 288, "CtexHeader layout is part of the file format");
+
+// Bytes per 4x4 block, 0 for uncompressed formats
+u32 CtexBlockBytes(u32 format);
+
+// Validates `data` as a .ctex file and returns its header, or nullptr
+const CtexHeader* ParseCtex(std::span<const u8> data);
@@ -1,7 +1,8 @@
 #pragma once
-#include <windows.h>
 #include <engine/utils.h>
 
+// Values are the Win32 virtual-key codes, so the Win32 backend indexes the
+// key arrays with wParam as is; other backends translate their own codes.
 enum KeyCode {
     // Letters
     KEY_A = 0x41,
@@ -44,43 +45,43 @@ enum KeyCode {
     KEY_9 = 0x39,
 
     // Arrow Keys
-    KEY_UP = VK_UP,
-    KEY_DOWN = VK_DOWN,
-    KEY_LEFT = VK_LEFT,
-    KEY_RIGHT = VK_RIGHT,
+    KEY_UP = 0x26,
+    KEY_DOWN = 0x28,
+    KEY_LEFT = 0x25,
+    KEY_RIGHT = 0x27,
 
     // Modifiers
-    KEY_SHIFT = VK_SHIFT,
-    KEY_CTRL  = VK_CONTROL,
-    KEY_ALT   = VK_MENU,
-    KEY_SPACE = VK_SPACE,
+    KEY_SHIFT = 0x10,
+    KEY_CTRL  = 0x11,
+    KEY_ALT   = 0x12,
+    KEY_SPACE = 0x20,
 
     // Function Keys
-    KEY_F1  = VK_F1,
-    KEY_F2  = VK_F2,
-    KEY_F3  = VK_F3,
-    KEY_F4  = VK_F4,
-    KEY_F5  = VK_F5,
-    KEY_F6  = VK_F6,
-    KEY_F7  = VK_F7,
-    KEY_F8  = VK_F8,
-    KEY_F9  = VK_F9,
-    KEY_F10 = VK_F10,
-    KEY_F11 = VK_F11,
-    KEY_F12 = VK_F12,
+    KEY_F1  = 0x70,
+    KEY_F2  = 0x71,
+    KEY_F3  = 0x72,
+    KEY_F4  = 0x73,
+    KEY_F5  = 0x74,
+    KEY_F6  = 0x75,
+    KEY_F7  = 0x76,
+    KEY_F8  = 0x77,
+    KEY_F9  = 0x78,
+    KEY_F10 = 0x79,
+    KEY_F11 = 0x7A,
+    KEY_F12 = 0x7B,
 
     // Special keys
-    KEY_TAB      = VK_TAB,
-    KEY_CAPSLOCK = VK_CAPITAL,
-    KEY_ENTER    = VK_RETURN,
-    KEY_BACKSPACE = VK_BACK,
-    KEY_ESCAPE   = VK_ESCAPE,
-    KEY_INSERT   = VK_INSERT,
-    KEY_DELETE   = VK_DELETE,
-    KEY_HOME     = VK_HOME,
-    KEY_END      = VK_END,
-    KEY_PAGEUP   = VK_PRIOR,
-    KEY_PAGEDOWN = VK_NEXT,
+    KEY_TAB      = 0x09,
+    KEY_CAPSLOCK = 0x14,
+    KEY_ENTER    = 0x0D,
+    KEY_BACKSPACE = 0x08,
+    KEY_ESCAPE   = 0x1B,
+    KEY_INSERT   = 0x2D,
+    KEY_DELETE   = 0x2E,
+    KEY_HOME     = 0x24,
+    KEY_END      = 0x23,
+    KEY_PAGEUP   = 0x21,
+    KEY_PAGEDOWN = 0x22,
 
     // Mouse buttons (optional)
     MOUSE_LEFT   = 0,
@@ -96,10 +97,49 @@ bool IsKeyUp(KeyCode keycode);
 
 ivec2 GetMousePos();
 vec2 GetMouseDelta();
+vec2 GetRawMouseDelta();
 i32 GetScrollY();
 
 bool GetMouseButtonDown(i32 button);
 bool GetMouseButtonUp(i32 button);
 
+// Next character typed during the last PollEvent, in typing order; call
+// until it returns false
+bool IsKeyTypedChar(c32* chr);
+// All of them at once
+std::span<const c32> GetTypedText();
 
-bool IsKeyTypedChar(c32* chr);
\ No newline at end of file
+// ============================
+// Input events
+// ============================
+// Backends record every key, button, motion, scroll and character event
+// with its timestamp as they drain the OS queue, instead of keeping only
+// each frame's final state. The functions above still answer per-frame
+// questions; code that needs order or timing (text fields, fixed-timestep
+// ticks) reads the events.
+#define INPUT_EVENT_CAPACITY 1024 // power of two; the oldest are overwritten
+#define INPUT_TEXT_CAPACITY 128   // characters per frame
+
+enum InputEventType : u8 {
+    INPUT_KEY_DOWN,
+    INPUT_KEY_UP,
+    INPUT_MOUSE_DOWN,
+    INPUT_MOUSE_UP,
+    INPUT_MOUSE_MOVE,
+    INPUT_SCROLL,
+    INPUT_CHAR,
+};
+
+struct InputEvent {
+    InputEventType type;
+    bool repeat;  // INPUT_KEY_DOWN from auto-repeat
+    u16 code;     // KeyCode or mouse button
+    i32 x, y;     // mouse position; the delta for INPUT_SCROLL, the character for INPUT_CHAR in x
+    double time;  // seconds on the backend's event clock; only differences mean anything
+};
+
+// Cursor at the first event the last PollEvent recorded
+u64 FrameInputCursor();
+// Next event after *cursor, advancing it; false once caught up. A cursor
+// the ring has already overwritten skips to the oldest event still held.
+bool ReadInputEvent(u64* cursor, InputEvent* event);
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+#include <engine/utils.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// ============================
+// Asynchronous file I/O
+// ============================
+// Reads are queued by priority and served by an io_uring ring on Linux
+// (ATLAS_IO_URING) or by a pool of blocking worker threads elsewhere.
+// Large reads are split into IO_CHUNK_SIZE pieces, so a cancelled or
+// lower-priority request never holds the device for a whole file.
+// Threads start with the first IoRead. If the ring fails, reads already
+// handed to the kernel are reaped and the rest are served by its thread as a
+// blocking worker.
+#define IO_CHUNK_SIZE MB(4)
+#define IO_QUEUE_DEPTH 64
+#define IO_MAX_ACTIVE_FILES 8
+
+enum IoPriority {
+    IO_PRIORITY_HIGH,   // needed this frame (e.g. blocking a visible asset)
+    IO_PRIORITY_NORMAL,
+    IO_PRIORITY_LOW,    // prefetch / streaming ahead
+    IO_PRIORITY_COUNT
+};
+
+enum IoStatus {
+    IO_PENDING,   // queued
+    IO_READING,
+    IO_DONE,
+    IO_FAILED,
+    IO_CANCELLED,
+};
+
+struct IoRequest {
+    std::string path;
+    u64 offset = 0;
+    u64 size = 0;            // 0 reads to the end of the file
+    u8* buffer = nullptr;    // allocated by the service unless the caller passed one
+    bool ownsBuffer = false;
+    IoPriority priority = IO_PRIORITY_NORMAL;
+
+    std::atomic<IoStatus> status{IO_PENDING};
+    std::atomic<bool> cancelRequested{false};
+    u64 bytesRead = 0;
+
+    // Runs right before the status becomes final, never under the service
+    // lock, so it may queue or cancel other reads. Usually on an I/O thread;
+    // a request dropped while still queued (IoCancel, ShutdownIoService, or
+    // IoRead after shutdown) completes on the thread that dropped it.
+    std::function<void(IoRequest&)> onComplete;
+
+    // Backend bookkeeping
+    intptr_t file = -1;
+    u64 submitted = 0;
+    u32 inFlight = 0;
+    bool failed = false;
+    bool endOfFile = false;
+
+    ~IoRequest();
+};
+
+typedef std::shared_ptr<IoRequest> IoHandle;
+
+// Starts the service (no threads until the first read); workerCount only
+// applies to the thread-pool backend
+bool InitIoService(u32 workerCount = 2);
+void ShutdownIoService();
+str IoBackendName();
+
+// Queues a read of [offset, offset + size) of `path`. When `buffer` is null
+// the service allocates size + 1 bytes (null-terminated) owned by the request.
+IoHandle IoRead(str path,
+                IoPriority priority = IO_PRIORITY_NORMAL,
+                u64 offset = 0,
+                u64 size = 0,
+                void* buffer = nullptr,
+                std::function<void(IoRequest&)> onComplete = {});
+
+bool IoIsDone(const IoHandle& handle);
+
+// Blocks until the request reaches a final status and returns it
+IoStatus IoWait(const IoHandle& handle);
+
+// Drops a queued request (completing it on the calling thread), or stops an
+// in-flight one after its current chunk
+void IoCancel(const IoHandle& handle);
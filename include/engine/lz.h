@@ -0,0 +1,80 @@
+#pragma once
+#include <engine/utils.h>
+#include <functional>
+
+// ============================
+// LZ block compression
+// ============================
+// LZ4-compatible block format: greedy single-probe hash compressor, and a
+// decoder that copies literals/matches 16 bytes at a time when there is room.
+// No external dependency; lz.cpp only needs the C runtime.
+
+// Worst-case compressed size for `size` input bytes
+size_t LzCompressBound(size_t size);
+
+// Returns the compressed size, or 0 if dstCapacity < LzCompressBound(srcSize)
+size_t LzCompress(const u8* src, size_t srcSize, u8* dst, size_t dstCapacity);
+
+// Returns the decompressed size, or -1 on malformed input / too small dst
+i64 LzDecompress(const u8* src, size_t srcSize, u8* dst, size_t dstCapacity);
+
+// ============================
+// Frame format
+// ============================
+//   LzFrameHeader
+//   blocks: u32 size (LZ_BLOCK_UNCOMPRESSED bit = stored raw), then data
+//   u32 0 end mark, u32 XXH32 of the whole content
+// Blocks are independent, so frames can be written and read as streams.
+#define LZ_FRAME_MAGIC 0x5A4C5441u // "ATLZ"
+#define LZ_BLOCK_UNCOMPRESSED 0x80000000u
+#define LZ_DEFAULT_BLOCK_SIZE MB(1)
+
+struct LzFrameHeader {
+    u32 magic;
+    u32 blockSize;   // max decompressed bytes per block
+    u64 contentSize; // 0 when unknown (streamed)
+};
+
+u32 XXH32(const void* data, size_t size, u32 seed = 0);
+
+struct Xxh32State {
+    u32 v[4];
+    u32 seed;
+    u64 total;
+    u8 buffer[16];
+    u32 buffered;
+};
+
+void Xxh32Begin(Xxh32State* state, u32 seed = 0);
+void Xxh32Update(Xxh32State* state, const void* data, size_t size);
+u32 Xxh32End(const Xxh32State* state);
+
+// Receives encoded or decoded bytes; return false to abort
+typedef std::function<bool(const u8* data, size_t size)> LzSink;
+
+// Streaming compressor: feed any amount with LzStreamWrite, blocks are
+// emitted to the sink as they fill up
+struct LzStreamWriter {
+    LzSink sink;
+    u32 blockSize;
+    array<u8> block;
+    array<u8> scratch;
+    size_t fill;
+    Xxh32State hash;
+    bool failed;
+};
+
+bool LzStreamBegin(LzStreamWriter* writer, LzSink sink, u32 blockSize = LZ_DEFAULT_BLOCK_SIZE, u64 contentSize = 0);
+bool LzStreamWrite(LzStreamWriter* writer, const void* data, size_t size);
+bool LzStreamEnd(LzStreamWriter* writer);
+
+size_t LzFrameBound(size_t size, u32 blockSize = LZ_DEFAULT_BLOCK_SIZE);
+
+// One-shot frame compression, returns the frame size or 0
+size_t LzFrameCompress(const u8* src, size_t srcSize, u8* dst, size_t dstCapacity, u32 blockSize = LZ_DEFAULT_BLOCK_SIZE);
+
+// Decodes a frame block by block into `sink` and verifies the checksum
+bool LzFrameDecode(const u8* src, size_t srcSize, const LzSink& sink);
+
+// One-shot frame decompression, returns the content size or -1
+i64 LzFrameDecompress(const u8* src, size_t srcSize, u8* dst, size_t dstCapacity);
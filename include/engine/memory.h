@@ -0,0 +1,455 @@
+#pragma once
+#include <engine/utils.h>
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <initializer_list>
+
+// ============================
+// Frame arena
+// ============================
+// Two bump allocators used alternately: everything allocated during frame N
+// stays valid through frame N + 1 (so the render side can still read it),
+// then the buffer is reset and reused for frame N + 2.
+struct FrameArena {
+    BumpAllocator buffers[2];
+    u32 current;
+    u64 frame;
+};
+
+extern FrameArena frameArena;
+
+// Each buffer reserves `perFrameReserve` bytes of address space and commits
+// pages as a frame needs them
+void InitFrameArena(FrameArena* arena, size_t perFrameReserve);
+void DestroyFrameArena(FrameArena* arena);
+
+// Flips to the other buffer and resets it. Call once at the start of a frame.
+void BeginFrameArena(FrameArena* arena);
+
+// Returns pages of the idle buffer beyond `keepCommitted` to the OS,
+// e.g. after a loading spike. Must be called right after BeginFrameArena.
+void TrimFrameArena(FrameArena* arena, size_t keepCommitted);
+
+BumpAllocator* FrameAllocator();
+void* FrameAlloc(size_t size, size_t align = alignof(max_align_t));
+
+// printf into frame memory, valid until the end of the next frame
+char* FrameFormat(str fmt, ...);
+
+// ============================
+// Scratch memory
+// ============================
+// Every thread owns SCRATCH_ARENA_COUNT reserved bump arenas, created on
+// first use, so temporary allocations never contend or lock. TempMemory
+// grabs one and rolls it back on scope exit:
+//
+//     TempMemory temp;
+//     float* xs = temp.Push<float>(count);
+//
+// A function that receives an arena from its caller (e.g. to return results
+// in it) passes that arena as a conflict so its own scratch is a different one:
+//
+//     TempMemory temp({resultArena});
+#define SCRATCH_ARENA_COUNT 2
+#define SCRATCH_ARENA_RESERVE GB(1)
+
+// Returns a scratch arena of the calling thread not in `conflicts`
+BumpAllocator* GetScratchArena(BumpAllocator* const* conflicts = nullptr, u32 conflictCount = 0);
+
+// Decommits the calling thread's scratch pages beyond `keepCommitted` bytes.
+// Only valid when no TempMemory scope is open on the thread.
+void TrimScratchArenas(size_t keepCommitted);
+
+// Gives the calling thread's scratch arenas back to the OS. For the main
+// thread at shutdown, before ReportMemoryLeaks; other threads release theirs
+// on exit.
+void ReleaseScratchArenas();
+
+struct TempMemory {
+    BumpAllocator* arena;
+    AllocatorMarker marker;
+
+    TempMemory(std::initializer_list<BumpAllocator*> conflicts = {})
+        : arena(GetScratchArena(conflicts.begin(), (u32)conflicts.size())),
+          marker(GetMarker(arena)) {}
+
+    ~TempMemory() { RollbackToMarker(marker); }
+
+    TempMemory(const TempMemory&) = delete;
+    TempMemory& operator=(const TempMemory&) = delete;
+
+    void* Alloc(size_t size, size_t align = alignof(max_align_t))
+    {
+        void* memory = BumpAllocAligned(arena, size, align);
+        Assert(memory, "Scratch arena out of memory (%zu bytes)", size);
+        return memory;
+    }
+
+    template <typename T>
+    T* Push(size_t count)
+    {
+        return (T*)Alloc(sizeof(T) * count, alignof(T));
+    }
+};
+
+// ============================
+// STL adapter
+// ============================
+// Lets std containers live in a bump allocator. deallocate only gives memory
+// back when it is the most recent allocation (e.g. a container destroyed
+// right after its last push). Growth is not that case: a vector allocates the
+// new buffer before freeing the old one, so reserve up front; everything else
+// is reclaimed by Reset/Rollback of the owning allocator.
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    BumpAllocator* arena;
+
+    ArenaAllocator(BumpAllocator* arena = FrameAllocator()) noexcept : arena(arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(size_t n)
+    {
+        void* memory = BumpAllocAligned(arena, n * sizeof(T), alignof(T));
+        Assert(memory, "ArenaAllocator out of memory");
+        if (!memory)
+            throw std::bad_alloc();
+        return (T*)memory;
+    }
+
+    void deallocate(T* p, size_t n) noexcept
+    {
+        if ((char*)p + n * sizeof(T) == arena->memory + arena->used)
+            arena->used = (char*)p - arena->memory;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena == other.arena; }
+};
+
+template <typename T>
+using frame_array = std::vector<T, ArenaAllocator<T>>;
+
+using frame_string = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+// ============================
+// Pool allocator
+// ============================
+// Fixed-size blocks carved from a private reserved range, recycled through an
+// intrusive free list. Each thread keeps a small cache of free blocks per
+// pool, so alloc/free only take the pool lock once per POOL_CACHE_BATCH ops;
+// a thread hands its cached blocks back when it exits.
+#define POOL_CACHE_BATCH 32
+#define POOL_THREAD_CACHES 16 // distinct pools a thread can cache at once
+#define POOL_DEFAULT_MAX_BLOCKS (1 << 20)
+
+struct PoolAllocator {
+    u32 id;
+    size_t blockSize; // stride including alignment padding
+    size_t blockAlign;
+    size_t maxBlocks;
+
+    BumpAllocator arena;
+    void* freeList;
+    std::mutex lock;
+
+    size_t carvedBlocks;
+    std::atomic<size_t> liveBlocks;
+    std::atomic<size_t> peakBlocks;
+
+    PoolAllocator* nextLive; // list of initialized pools, for thread exit
+};
+
+struct PoolStats {
+    size_t blockSize;
+    size_t maxBlocks;
+    size_t carvedBlocks; // blocks ever handed out of the arena
+    size_t liveBlocks;
+    size_t peakBlocks;
+    size_t committedBytes;
+    float utilization;   // live / carved
+};
+
+void InitPool(PoolAllocator* pool, size_t blockSize, size_t blockAlign, size_t maxBlocks);
+void DestroyPool(PoolAllocator* pool);
+void* PoolAlloc(PoolAllocator* pool);
+void PoolFree(PoolAllocator* pool, void* block);
+PoolStats GetPoolStats(PoolAllocator* pool);
+
+// Sized pools live until exit (containers in static storage may still hold
+// their blocks), so ReportMemoryLeaks leaves their arenas out
+void RegisterSizedPool(PoolAllocator* pool);
+
+// One process-wide pool per block size/alignment, created on first use
+template <size_t Size, size_t Align>
+PoolAllocator* GetSizedPool()
+{
+    static PoolAllocator* pool = []
+    {
+        // Static storage, not new: the pool itself must not show up as a leak
+        static PoolAllocator storage;
+        InitPool(&storage, Size, Align, POOL_DEFAULT_MAX_BLOCKS);
+        RegisterSizedPool(&storage);
+        return &storage;
+    }();
+    return pool;
+}
+
+// STL adapter that serves single-object allocations (map/list nodes) from
+// the sized pool and forwards arrays (bucket tables) to the heap.
+template <typename T>
+struct PoolStlAllocator {
+    using value_type = T;
+
+    PoolStlAllocator() noexcept = default;
+
+    template <typename U>
+    PoolStlAllocator(const PoolStlAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n)
+    {
+        if (n == 1)
+            return (T*)PoolAlloc(GetSizedPool<sizeof(T), alignof(T)>());
+        return (T*)::operator new(n * sizeof(T));
+    }
+
+    void deallocate(T* p, size_t n) noexcept
+    {
+        if (n == 1)
+            PoolFree(GetSizedPool<sizeof(T), alignof(T)>(), p);
+        else
+            ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const PoolStlAllocator<U>&) const noexcept { return true; }
+};
+
+// ============================
+// Typed object pool
+// ============================
+// Objects live in one contiguous reserved range indexed by handle, so
+// pointers are stable and a stale handle is detected by its generation.
+struct PoolHandle {
+    u32 index;
+    u32 generation; // 0 is never valid
+
+    bool operator==(const PoolHandle& other) const { return index == other.index && generation == other.generation; }
+};
+
+template <typename T>
+class Pool
+{
+public:
+    explicit Pool(size_t maxCount = 1 << 16)
+        : maxCount(maxCount)
+    {
+        arena = MakeAllocator(maxCount * sizeof(Slot));
+        slots = (Slot*)arena.memory;
+    }
+
+    ~Pool()
+    {
+        for (u32 i = 0; i < slotCount; i++)
+        {
+            if (slots[i].generation & 1)
+                slots[i].Get()->~T();
+        }
+        ReleaseAllocator(&arena);
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    template <typename... Args>
+    PoolHandle Create(Args&&... args)
+    {
+        u32 index;
+        if (freeHead != NO_SLOT)
+        {
+            index = freeHead;
+            freeHead = slots[index].nextFree;
+        }
+        else
+        {
+            void* memory = BumpAllocAligned(&arena, sizeof(Slot), alignof(Slot));
+            Assert(memory, "Pool<T> full (%zu objects)", maxCount);
+            if (!memory)
+                return PoolHandle{};
+            index = slotCount++;
+            slots[index].generation = 0;
+        }
+
+        Slot& slot = slots[index];
+        new (slot.storage) T(std::forward<Args>(args)...);
+        slot.generation++; // odd = alive
+        liveCount++;
+        peakCount = std::max(peakCount, liveCount);
+        return PoolHandle{index, slot.generation};
+    }
+
+    void Destroy(PoolHandle handle)
+    {
+        T* object = Get(handle);
+        if (!object)
+            return;
+
+        object->~T();
+        Slot& slot = slots[handle.index];
+        slot.generation++; // even = free
+        slot.nextFree = freeHead;
+        freeHead = handle.index;
+        liveCount--;
+    }
+
+    T* Get(PoolHandle handle)
+    {
+        if (handle.index >= slotCount || slots[handle.index].generation != handle.generation || !(handle.generation & 1))
+            return nullptr;
+        return slots[handle.index].Get();
+    }
+
+    template <typename Fn>
+    void ForEach(Fn&& fn)
+    {
+        for (u32 i = 0; i < slotCount; i++)
+        {
+            if (slots[i].generation & 1)
+                fn(PoolHandle{i, slots[i].generation}, *slots[i].Get());
+        }
+    }
+
+    size_t Count() const { return liveCount; }
+
+    PoolStats Stats() const
+    {
+        PoolStats stats{};
+        stats.blockSize = sizeof(Slot);
+        stats.maxBlocks = maxCount;
+        stats.carvedBlocks = slotCount;
+        stats.liveBlocks = liveCount;
+        stats.peakBlocks = peakCount;
+        stats.committedBytes = arena.committed;
+        stats.utilization = slotCount ? (float)liveCount / (float)slotCount : 0.0f;
+        return stats;
+    }
+
+private:
+    static constexpr u32 NO_SLOT = 0xFFFFFFFF;
+
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        u32 generation;
+        u32 nextFree;
+
+        T* Get() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    BumpAllocator arena;
+    Slot* slots = nullptr;
+    size_t maxCount;
+    u32 slotCount = 0;
+    u32 freeHead = NO_SLOT;
+    size_t liveCount = 0;
+    size_t peakCount = 0;
+};
+
+// ============================
+// Allocation tracking
+// ============================
+enum MemoryTag {
+    MEM_GENERAL, // untagged global operator new (ATLAS_TRACK_GLOBAL_NEW)
+    MEM_ARENA,   // pages committed by bump allocators, pools and scratch
+    MEM_ECS,
+    MEM_RENDER,
+    MEM_ASSETS,
+    MEM_FONTS,
+    MEM_AUDIO,
+    MEM_EXTERNAL, // global operator new called from other modules (GL driver)
+    MEM_TAG_COUNT
+};
+
+struct MemoryTagStats {
+    i64 liveBytes;
+    i64 peakBytes;
+    u64 allocCount;      // total since start
+    u64 liveAllocs;
+    u64 frameAllocs;     // during the last completed frame
+    u64 frameBytes;
+};
+
+struct MemoryStats {
+    MemoryTagStats tags[MEM_TAG_COUNT];
+    i64 totalLiveBytes;
+    i64 totalPeakBytes;
+    u64 frameAllocs;
+};
+
+str MemoryTagName(MemoryTag tag);
+
+void TrackAlloc(MemoryTag tag, size_t size);
+void TrackFree(MemoryTag tag, size_t size);
+// A live allocation grew or shrank in place (an arena committing pages)
+void TrackResize(MemoryTag tag, i64 delta);
+
+// malloc/realloc/free that remember size and tag in a small header
+void* TrackedMalloc(MemoryTag tag, size_t size);
+void* TrackedRealloc(MemoryTag tag, void* ptr, size_t size);
+void TrackedFree(void* ptr);
+
+MemoryStats GetMemoryStats();
+
+// Latches this frame's allocation counts into the stats and starts a new frame
+void EndMemoryFrame();
+
+// Prints every tag that still has live allocations. Returns the leaked bytes.
+// MEM_EXTERNAL is left out, libraries keep their own state until exit. With
+// ATLAS_TRACK_GLOBAL_NEW, containers with static storage only free during
+// static destruction, so the report then runs at exit on its own.
+i64 ReportMemoryLeaks();
+
+// Tag used by global operator new on this thread while the scope is alive
+struct MemoryTagScope {
+    MemoryTag previous;
+
+    explicit MemoryTagScope(MemoryTag tag);
+    ~MemoryTagScope();
+};
+
+// STL adapter that accounts a container's heap storage to a tag
+template <typename T, MemoryTag Tag>
+struct TaggedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = TaggedAllocator<U, Tag>; };
+
+    TaggedAllocator() noexcept = default;
+
+    template <typename U>
+    TaggedAllocator(const TaggedAllocator<U, Tag>&) noexcept {}
+
+    T* allocate(size_t n)
+    {
+        T* p = (T*)::operator new(n * sizeof(T));
+        TrackAlloc(Tag, n * sizeof(T));
+        return p;
+    }
+
+    void deallocate(T* p, size_t n) noexcept
+    {
+        TrackFree(Tag, n * sizeof(T));
+        ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const TaggedAllocator<U, Tag>&) const noexcept { return true; }
+};
+
+template <typename T, MemoryTag Tag>
+using tagged_array = std::vector<T, TaggedAllocator<T, Tag>>;
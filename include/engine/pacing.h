@@ -0,0 +1,47 @@
+#pragma once
+#include <engine/utils.h>
+#include <platform/platform.h>
+
+// ============================
+// Frame pacing
+// ============================
+// Ends each frame at a fixed deadline instead of starting the next one as
+// soon as the last swap returns. The wait sleeps while a sleep is known to
+// return in time, then spins the last stretch: sleeps overshoot by a
+// scheduler-dependent amount, so the pacer measures how long 1 ms requests
+// really take and keeps that estimate (mean + one standard deviation).
+//
+// In idle mode frames are only rendered after RequestRedraw (or window
+// activity); between them the loop blocks in WaitForEvents, so a static
+// menu costs nothing instead of rendering identical frames.
+#define FRAME_PACER_IDLE_MS 100 // longest idle wait: file watcher and texture uploads poll at this rate
+
+struct FramePacer {
+    double targetFrameTime = 0.0; // seconds, 0 = no cap (vsync or nothing)
+    double deadline = 0.0;        // end of the current frame, pacer clock
+    bool idleMode = false;
+    bool redraw = true;           // something visible changed since the last rendered frame
+    u64 skippedFrames = 0;        // not rendered in idle mode
+
+    // How long a 1 ms sleep request takes, measured
+    double sleepEstimate = 0.005;
+    double sleepMean = 0.005;
+    double sleepM2 = 0.0;
+    u64 sleepCount = 1;
+};
+
+// targetFps 0 leaves pacing to the swap interval. Headless runs are never
+// paced or idle: their frame time is virtual.
+void InitFramePacer(FramePacer* pacer, u32 targetFps, bool idleMode);
+void SetTargetFps(FramePacer* pacer, u32 targetFps);
+
+// Something visible changed: the next frame renders even in idle mode
+void RequestRedraw(FramePacer* pacer);
+
+// After PollEvent and updates: true if this frame should be drawn. False
+// only in idle mode with no redraw requested and no window activity.
+bool ShouldRender(FramePacer* pacer, const Event& event);
+
+// Last thing in a frame, after SwapBuffersWindow or in place of drawing.
+// Sleeps + spins to the frame deadline, or waits for events when idle.
+void WaitForNextFrame(FramePacer* pacer, bool rendered);
@@ -0,0 +1,68 @@
+#pragma once
+#include <engine/utils.h>
+
+// ============================
+// Asset pack (.pak)
+// ============================
+// Layout:
+//   PackHeader
+//   entry data, each entry starting on a PACK_ALIGNMENT boundary
+//   PackEntry[entryCount], sorted by pathHash
+//   path string table (null-terminated, '/' separators)
+//
+// The whole file is mapped once; uncompressed entries are returned as spans
+// straight into the mapping. Compressed entries are LZ frames (engine/lz.h)
+// and are only kept when they save at least 1/8 of the raw size.
+#define PACK_MAGIC 0x4B505441u // "ATPK"
+#define PACK_VERSION 1
+#define PACK_ALIGNMENT 4096
+
+enum PackCompression : u32 {
+    PACK_COMPRESSION_NONE = 0,
+    PACK_COMPRESSION_LZ = 1,
+};
+
+struct PackHeader {
+    u32 magic;
+    u32 version;
+    u32 entryCount;
+    u32 reserved;
+    u64 tocOffset;
+    u64 stringsOffset;
+    u64 stringsSize;
+};
+
+struct PackEntry {
+    u64 pathHash;   // HashString of the normalized path
+    u64 offset;     // from the start of the pack
+    u64 size;       // stored bytes
+    u64 rawSize;    // bytes after decompression
+    u32 pathOffset; // into the string table
+    u32 compression;
+};
+
+static_assert(sizeof(PackHeader) == 40, "PackHeader layout is part of the file format");
+static_assert(sizeof(PackEntry) == 40, "PackEntry layout is part of the file format");
+
+struct PackFile {
+    MappedFile file;
+    const PackHeader* header = nullptr;
+    const PackEntry* entries = nullptr;
+    const char* strings = nullptr;
+};
+
+bool OpenPack(PackFile* pack, str path);
+void ClosePack(PackFile* pack);
+
+// Binary search by hash; `path` (optional) guards against hash collisions
+const PackEntry* FindPackEntry(const PackFile* pack, u64 pathHash, str path = nullptr);
+const PackEntry* FindPackEntry(const PackFile* pack, str path);
+
+str GetPackEntryPath(const PackFile* pack, const PackEntry* entry);
+
+// Stored bytes of the entry, zero-copy. Only usable as-is when the entry is
+// uncompressed; compressed entries must go through ReadPackEntry.
+std::span<const u8> GetPackEntryData(const PackFile* pack, const PackEntry* entry);
+
+// Copies (and decompresses) the entry into `dst`, which holds entry->rawSize bytes
+bool ReadPackEntry(const PackFile* pack, const PackEntry* entry, u8* dst);
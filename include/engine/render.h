@@ -0,0 +1,42 @@
+#pragma once
+#include <engine/utils.h>
+#include <engine/memory.h>
+
+#define CIRCLE_MAX_SEGMENTS 256
+
+struct Vertex
+{
+    vec2 pos;
+    vec2 uv;
+    vec4 color;
+};
+
+struct Batch
+{
+    u32 vao{}, vbo{}, ebo{};
+    u32 tex{0};
+    u32 shader{0}; // ShaderFeature bits, the key of the program variant that draws it
+    i32 w{}, h{}, chs{};
+    tagged_array<Vertex, MEM_RENDER> vertices;
+    tagged_array<u32, MEM_RENDER> indices;
+
+    void reserve(size_t quadCount)
+    {
+        vertices.reserve(quadCount * 4); // 4 vertices per quad
+        indices.reserve(quadCount * 6);  // 6 indices per quad
+    }
+};
+
+// Axis-aligned rectangle in screen space, (0,0) is bottom-left
+struct Rect
+{
+    vec2 min;
+    vec2 max;
+};
+
+extern array<Batch> batches;
+
+void DrawQuad(Batch &b, vec2 pos, vec2 size, ivec2 ioffset, ivec2 isize, vec4 color = vec4(1.0f), bool flipX = false, bool flipY = false);
+void DrawRect(vec2 pos, vec2 size, ivec2 ioffset, ivec2 isize, vec4 color = vec4(1.0f), bool flipX = false, bool flipY = false);
+// segment is clamped to [3, CIRCLE_MAX_SEGMENTS]
+void DrawCircle(vec2 pos, float radius, int segment = 8, vec4 color = vec4(1.0f));
@@ -1,8 +1,126 @@
 #pragma once
 #include <engine/utils.h>
+#include <engine/vfs.h>
+#include <unordered_map>
 
-u32 CompileShader(const char* source, i32 type);
-u32 CreateShaderProgram(str vertPath, str fragPath);
+// length < 0 means `source` is null-terminated
+u32 CompileShader(const char* source, i32 type, i32 length = -1);
 
-template<typename T> 
-void SetUniform(u32 program, str name, T value);
\ No newline at end of file
+// Linked programs are cached as driver binaries (glGetProgramBinary) in
+// SHADER_CACHE_DIR, keyed by a hash of both sources and the GL vendor,
+// renderer and version strings, so later runs skip compiling. A binary the
+// driver rejects falls back to compiling from source.
+#define SHADER_CACHE_DIR "shadercache"
+
+// Returns 0 if a file is missing or compiling / linking fails
+u32 CreateShaderProgram(VfsPath vertPath, VfsPath fragPath);
+
+// ============================
+// Preprocessor
+// ============================
+// Runs before the driver sees the source. `#include "file"` lines are
+// replaced by the file, resolved relative to the including file; each file
+// is included once. `defines` become `#define NAME` lines right after
+// #version. Every file read is listed in `files`, and #line directives
+// number them by that index, so a compile error "1:12" is line 12 of
+// files[1]. Line based: an #include inside #if or a comment still expands.
+bool PreprocessShader(VfsPath path, std::span<const std::string> defines, std::string* out, array<std::string>* files);
+
+// Permutation keys: each set bit compiles a variant with its #define, so
+// shaders select behavior with #ifdef instead of branching on a uniform
+enum ShaderFeature : u32 {
+    SHADER_FEATURE_TEXT = 1 << 0,       // TEXT: single-channel coverage atlas
+    SHADER_FEATURE_ALPHA_TEST = 1 << 1, // ALPHA_TEST: discard nearly transparent texels
+    SHADER_FEATURE_SDF = 1 << 2,        // SDF: signed distance field atlas
+};
+
+#define SHADER_FEATURE_COUNT 3
+#define SHADER_VARIANT_COUNT (1 << SHADER_FEATURE_COUNT)
+
+array<std::string> ShaderFeatureDefines(u32 features);
+
+// ============================
+// Shader programs
+// ============================
+// Active uniforms and attributes are reflected once after linking into
+// tables keyed by the hash of their name, so setting a uniform is a hash
+// lookup instead of a glGetUniformLocation string search. Each uniform
+// remembers the last value uploaded and identical values are skipped.
+#define SHADER_UNIFORM_VALUE_MAX 64 // largest cached value, a mat4
+
+// A uniform / attribute name with its precomputed hash. String literals are
+// hashed at compile time; runtime strings have to be wrapped explicitly.
+struct ShaderName {
+    str name;
+    u64 hash;
+
+    template <size_t N>
+    consteval ShaderName(const char (&literal)[N])
+        : name(literal), hash(HashString(std::string_view(literal, N - 1))) {}
+
+    explicit constexpr ShaderName(str name) : name(name), hash(HashString(name)) {}
+};
+
+struct ShaderUniform {
+    i32 location;
+    u32 type;   // GL_FLOAT_VEC2, GL_SAMPLER_2D, ...
+    i32 count;  // array length, 1 for plain uniforms
+    bool cached; // `value` holds what was last uploaded
+    alignas(16) u8 value[SHADER_UNIFORM_VALUE_MAX];
+};
+
+struct ShaderAttribute {
+    i32 location;
+    u32 type;
+};
+
+struct ShaderProgram {
+    u32 id = 0;
+    std::unordered_map<u64, ShaderUniform> uniforms;     // arrays are keyed by their name without "[0]"
+    std::unordered_map<u64, ShaderAttribute> attributes;
+};
+
+// Builds and reflects a program. On success the previous contents of
+// *program are destroyed and replaced; on failure *program is untouched, so
+// reloading a broken edit keeps the old program running.
+bool LoadShaderProgram(ShaderProgram* program, VfsPath vertPath, VfsPath fragPath);
+
+struct ShaderSource {
+    ShaderProgram* program;
+    VfsPath vertPath;
+    VfsPath fragPath;
+    u32 features = 0; // ShaderFeature bits
+};
+
+// Same for several programs at once. All of them are submitted before any
+// result is queried, so with GL_KHR_parallel_shader_compile the driver
+// compiles them concurrently. Returns false if any failed. Files read,
+// includes too, are added to `files` (e.g. to watch for hot reload).
+bool LoadShaderPrograms(std::span<const ShaderSource> sources, array<std::string>* files = nullptr);
+
+// One vertex / fragment pair built once per permutation key in use. Draws
+// carry their key (Batch::shader) and pick the program with it.
+struct ShaderVariants {
+    std::string vertPath;
+    std::string fragPath;
+    array<u32> keys;
+    ShaderProgram programs[SHADER_VARIANT_COUNT]; // id 0 for keys not built
+    array<std::string> files; // every file the last build read
+};
+
+bool LoadShaderVariants(ShaderVariants* variants, VfsPath vertPath, VfsPath fragPath, std::span<const u32> keys);
+// Rebuilds the same keys; each variant is replaced only if it built
+bool ReloadShaderVariants(ShaderVariants* variants);
+ShaderProgram* GetShaderVariant(ShaderVariants* variants, u32 key);
+void DestroyShaderVariants(ShaderVariants* variants);
+
+void DestroyShaderProgram(ShaderProgram* program);
+
+// nullptr / -1 when the name isn't active (unused names get optimized out)
+const ShaderUniform* FindUniform(const ShaderProgram& program, ShaderName name);
+i32 GetAttributeLocation(const ShaderProgram& program, ShaderName name);
+
+// Uploads with glProgramUniform*, so the program doesn't need to be bound.
+// Inactive names are ignored, like glUniform* with location -1.
+template<typename T>
+void SetUniform(ShaderProgram* program, ShaderName name, const T& value);
@@ -0,0 +1,49 @@
+#pragma once
+#include <engine/render.h>
+
+// ============================
+// Immediate-mode 2D shapes
+// ============================
+// Every call appends straight into the batch vertex/index arrays: one
+// resize per primitive (or per call for the array variants), no temporary
+// heap storage. Shapes sample uv (0,0) like DrawCircle, so the batch texture
+// should have an opaque texel there (or use a white texture).
+
+enum LineJoin
+{
+    JOIN_MITER, // falls back to bevel past the miter limit
+    JOIN_BEVEL,
+};
+
+// Pointers into freshly appended batch storage. `base` is the index of the
+// first new vertex, to be added to the local indices written into `indices`.
+struct GeometryWriter
+{
+    Vertex *vertices;
+    u32 *indices;
+    u32 base;
+};
+
+// Grows the batch capacity geometrically so a frame's worth of shapes
+// settles into zero reallocations. Call with the expected totals up front.
+void ReserveGeometry(Batch &b, size_t vertexCount, size_t indexCount);
+
+// Appends vertexCount/indexCount uninitialised slots to the batch.
+GeometryWriter AllocGeometry(Batch &b, u32 vertexCount, u32 indexCount);
+
+void DrawLine(Batch &b, vec2 p0, vec2 p1, float thickness, vec4 color = vec4(1.0f));
+
+// Draws count / 2 independent segments (points[0]-points[1], points[2]-points[3], ...)
+void DrawLines(Batch &b, const vec2 *points, u32 count, float thickness, vec4 color = vec4(1.0f));
+
+void DrawPolyline(Batch &b, const vec2 *points, u32 count, float thickness, vec4 color = vec4(1.0f),
+                  LineJoin join = JOIN_MITER, bool closed = false);
+
+// Angles in radians, counter-clockwise from +x
+void DrawArc(Batch &b, vec2 center, float radius, float startAngle, float endAngle, float thickness,
+             vec4 color = vec4(1.0f), int segments = 16);
+
+void DrawRoundedRect(Batch &b, vec2 pos, vec2 size, float radius, vec4 color = vec4(1.0f), int cornerSegments = 4);
+
+// Points must describe a convex polygon, either winding
+void DrawConvexPolygon(Batch &b, const vec2 *points, u32 count, vec4 color = vec4(1.0f));
@@ -0,0 +1,92 @@
+#pragma once
+#include <engine/render.h>
+#include <engine/vfs.h>
+#include <string_view>
+#include <unordered_map>
+
+#define FONT_FIRST_CHAR 32
+#define FONT_LAST_CHAR 127
+#define FONT_CHAR_COUNT (FONT_LAST_CHAR - FONT_FIRST_CHAR + 1)
+#define FONT_ATLAS_SIZE 1024 // glyph atlas width and height in pixels
+
+struct Glyph
+{
+    ivec2 size;
+    ivec2 bearing;
+    u32 advance;
+    ivec2 atlasPos;
+};
+
+struct Font
+{
+    Glyph glyphs[FONT_CHAR_COUNT];
+
+    // Kerning pairs precomputed at load time, key = (left << 8) | right,
+    // value = x adjustment in pixels. Only non-zero pairs are stored.
+    std::unordered_map<u32, i32> kerning;
+
+    i32 lineHeight = 0;
+    i32 ascender = 0;
+    i32 descender = 0; // negative, below the baseline
+};
+
+extern Font font;
+
+bool LoadFont(int width, VfsPath filepath = "assets/fonts/arial.ttf");
+
+// ============================
+// Text layout
+// ============================
+
+// A glyph placed on its line, x in unscaled font pixels from the line start
+struct ShapedGlyph
+{
+    float x;
+    u8 c;
+};
+
+struct TextLine
+{
+    u32 first; // index into ShapedRun::glyphs
+    u32 count;
+    float width;
+};
+
+// Result of kerning + line breaking a string. Cached by text and wrap width,
+// or by a caller's run id, so shaping cost is only paid the first time a
+// string is seen.
+struct ShapedRun
+{
+    std::string text;
+    float maxWidth = 0.0f;
+    u64 version = 0;        // caller's version, for runs cached by id
+    array<ShapedGlyph> glyphs;
+    array<TextLine> lines;
+    float width = 0.0f;
+    u64 lastUsedFrame = 0;
+};
+
+// maxWidth is in unscaled font pixels; <= 0 disables wrapping.
+const ShapedRun &ShapeText(std::string_view text, float maxWidth = 0.0f);
+
+// Cached by a stable id the caller picks instead of by content: a hit costs
+// neither hashing nor comparing the text, which matters for long, growing
+// text like logs. Bump `version` whenever the text changes.
+const ShapedRun &ShapeText(u64 runId, u64 version, std::string_view text, float maxWidth = 0.0f);
+
+vec2 MeasureText(std::string_view text, float scale, float maxWidth = 0.0f);
+
+// Emits quads for the lines of `run` intersecting `clip`. (x, y) is the
+// baseline of the first line; lines advance downwards. Lines outside the clip
+// rect are skipped without touching their glyphs.
+void RenderTextRun(const ShapedRun &run, float x, float y, float scale, vec4 color, Rect clip);
+
+void RenderText(std::string_view text, float x, float y, float scale, vec4 color);
+
+// Wraps text to the width of `box` and draws only the lines visible inside it.
+// scrollY moves the text up by that many pixels (for scrolling logs).
+void RenderTextBox(std::string_view text, Rect box, float scale, vec4 color, float scrollY = 0.0f);
+void RenderTextBox(u64 runId, u64 version, std::string_view text, Rect box, float scale, vec4 color, float scrollY = 0.0f);
+
+// Advances the text cache frame and evicts runs unused for a while.
+void EndTextFrame();
@@ -0,0 +1,64 @@
+#pragma once
+#include <engine/utils.h>
+#include <engine/memory.h>
+#include <engine/vfs.h>
+
+// ============================
+// Asynchronous textures
+// ============================
+// LoadTextureAsync returns immediately. Worker threads read and decode the
+// image, then hand the pixels to the render thread through a lock-free
+// queue. UpdateTextures uploads them through a persistently mapped pixel
+// buffer, a few rows at a time within a per-frame time budget. Until its
+// upload finishes a texture reports the placeholder's id and size.
+//
+// A cooked "name.ctex" next to "name.png" (tools/texcook) is used instead
+// of the source when present: its levels are copied from the mapping with
+// no decoding. Textures are premultiplied alpha either way, so draw with
+// glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA).
+//
+// While the file watcher runs, a texture whose source or cooked file changes
+// is loaded again the same way and swapped in once fully uploaded; the old
+// one keeps drawing until then, and also if the reload fails.
+#define TEXTURE_PLACEHOLDER_PATH "assets/textures/default_sprite.png"
+#define TEXTURE_MAX_COUNT 4096
+#define TEXTURE_STAGING_SLICE MB(1)   // upload granularity
+#define TEXTURE_STAGING_SLICES 4      // slices in flight on the GPU
+#define TEXTURE_UPLOAD_BUDGET_MS 2.0  // default render-thread time per frame
+
+enum TextureState {
+    TEXTURE_LOADING,   // queued or decoding on a worker
+    TEXTURE_UPLOADING, // decoded, rows streaming to the GPU
+    TEXTURE_READY,
+    TEXTURE_FAILED,    // keeps showing the placeholder
+};
+
+enum TextureFilter {
+    TEXTURE_FILTER_NEAREST,
+    TEXTURE_FILTER_LINEAR,
+};
+
+typedef PoolHandle TextureHandle;
+
+// Needs a current GL context; loads the placeholder synchronously
+bool InitTextures(u32 workerCount = 2);
+void ShutdownTextures();
+
+// Handles are owned by the render thread; only the decode runs elsewhere
+TextureHandle LoadTextureAsync(VfsPath path, TextureFilter filter = TEXTURE_FILTER_NEAREST);
+void DestroyTexture(TextureHandle handle);
+
+TextureState GetTextureState(TextureHandle handle);
+u32 GetTextureId(TextureHandle handle);
+ivec2 GetTextureSize(TextureHandle handle);
+
+// Render thread, once per frame: takes decoded images off the queue and
+// uploads until `budgetMs` is spent or the staging slices are all in flight
+void UpdateTextures(double budgetMs = TEXTURE_UPLOAD_BUDGET_MS);
+
+// Blocks until every queued texture is ready or failed, e.g. behind a loading screen
+void FlushTextures();
+
+// True while any load is decoding or uploading, i.e. UpdateTextures still has
+// work coming; an idle frame loop should keep running until it is false
+bool TexturesPending();
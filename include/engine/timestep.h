@@ -0,0 +1,56 @@
+#pragma once
+#include <engine/utils.h>
+#include <functional>
+
+// ============================
+// Fixed timestep
+// ============================
+// Simulation advances in ticks of exactly `step` seconds, however long the
+// frame took: frame time goes into an accumulator and each whole step in it
+// runs one tick. Results no longer depend on the frame rate, and the same
+// inputs give the same ticks. Rendering shows state between the last two
+// ticks by `alpha`, the leftover fraction of a step (see Interpolated).
+#define FIXED_TICK_RATE 60 // ticks per second
+#define FIXED_MAX_STEPS 5  // ticks per frame before time is dropped
+
+typedef std::function<void(float step)> TickCallback;
+
+struct FixedTimestep {
+    double step = 1.0 / FIXED_TICK_RATE; // seconds per tick
+    double accumulator = 0.0;            // time not simulated yet, < step between frames
+    u32 maxSteps = FIXED_MAX_STEPS;
+    u64 tick = 0;                        // ticks run so far
+    double droppedTime = 0.0;            // seconds discarded by the maxSteps cap
+    float alpha = 0.0f;                  // accumulator / step
+};
+
+void InitFixedTimestep(FixedTimestep* timestep, u32 tickRate = FIXED_TICK_RATE, u32 maxSteps = FIXED_MAX_STEPS);
+
+// Adds one frame's deltaTime and runs every tick now due, at most maxSteps.
+// If a frame is too slow for that, the rest is dropped rather than carried
+// over, so a slow tick can't make the next frame slower still (the spiral of
+// death): the simulation runs behind the wall clock instead. Returns the
+// number of ticks run.
+u32 AdvanceFixedTimestep(FixedTimestep* timestep, float deltaTime, const TickCallback& tick);
+
+// Simulation only: `ticks` ticks back to back, no clock and no cap, as fast
+// as they run (servers, replays, soak tests)
+void RunFixedTicks(FixedTimestep* timestep, u64 ticks, const TickCallback& tick);
+
+// State a tick writes and a frame draws. Set once per tick; Get(alpha)
+// blends the last two ticks, so motion stays smooth when the frame rate and
+// tick rate differ. T needs +, - and * float (float, vec2, vec3, vec4).
+template <typename T>
+struct Interpolated {
+    T previous{};
+    T current{};
+
+    // Jumps without blending from the old value (spawn, teleport)
+    void Reset(const T& value) { previous = current = value; }
+    void Set(const T& value)
+    {
+        previous = current;
+        current = value;
+    }
+    T Get(float alpha) const { return previous + (current - previous) * alpha; }
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include <engine/utils.h>
+#include <stddef.h>
+
+// ============================
+// std140 layout
+// ============================
+// Uniform block structs mirror a `layout(std140) uniform` block in GLSL
+// member for member. std140 puts vec2 on 8 bytes, vec3 / vec4 / mat4 on 16
+// and pads every mat3 column to a vec4, which plain C++ layout doesn't, so
+// every block struct asserts its offsets and size next to its definition.
+#define STD140_OFFSET(type, member, offset) \
+    static_assert(offsetof(type, member) == (offset), #type "::" #member " is not at its std140 offset")
+#define STD140_SIZE(type, size) \
+    static_assert(sizeof(type) == (size) && sizeof(type) % 16 == 0, #type " does not match its std140 size")
+
+struct alignas(16) Std140Vec3 {
+    vec3 value;
+    float pad;
+
+    Std140Vec3() : pad(0.0f) {}
+    Std140Vec3(vec3 v) : value(v), pad(0.0f) {}
+};
+
+struct alignas(16) Std140Mat3 {
+    vec4 columns[3];
+
+    Std140Mat3() = default;
+    Std140Mat3(const mat3& m)
+    {
+        for (i32 c = 0; c < 3; c++)
+            columns[c] = vec4(m.m[c * 3], m.m[c * 3 + 1], m.m[c * 3 + 2], 0.0f);
+    }
+};
+
+// ============================
+// Uniform buffers
+// ============================
+// One persistently mapped buffer holding UNIFORM_BUFFER_REGIONS copies of a
+// block. Each update writes the next region, waiting only if the GPU is
+// still reading it from UNIFORM_BUFFER_REGIONS frames ago, and binds it to
+// the block's binding point with glBindBufferRange. Every program using the
+// block sees the new values without any per-program uploads.
+#define UNIFORM_BUFFER_REGIONS 3
+
+// Binding points; LoadShaderProgram binds blocks by name
+#define UNIFORM_BINDING_FRAME 0
+
+struct UniformBuffer {
+    u32 id = 0;
+    u8* memory = nullptr;
+    u32 binding = 0;
+    u32 blockSize = 0;  // size rounded up to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    u32 region = 0;     // last written
+    void* fences[UNIFORM_BUFFER_REGIONS] = {}; // GLsync
+};
+
+bool CreateUniformBuffer(UniformBuffer* buffer, u32 binding, u32 size);
+void DestroyUniformBuffer(UniformBuffer* buffer);
+
+// Once per frame (or view) before the draws that read it
+void UpdateUniformBuffer(UniformBuffer* buffer, const void* data, u32 size);
+
+template <typename T>
+void UpdateUniformBuffer(UniformBuffer* buffer, const T& block)
+{
+    UpdateUniformBuffer(buffer, &block, sizeof(T));
+}
+
+// Binding point for a GLSL block name, or -1 for unknown blocks
+i32 UniformBlockBinding(std::string_view blockName);
+
+// ============================
+// Per-frame constants
+// ============================
+// layout(std140) uniform FrameConstants
+// {
+//     mat4 projection;
+//     vec2 screenSize;
+//     float time;
+//     float deltaTime;
+// };
+struct alignas(16) FrameConstants {
+    mat4 projection;
+    vec2 screenSize;
+    float time;      // seconds since start
+    float deltaTime;
+};
+
+STD140_OFFSET(FrameConstants, projection, 0);
+STD140_OFFSET(FrameConstants, screenSize, 64);
+STD140_OFFSET(FrameConstants, time, 72);
+STD140_OFFSET(FrameConstants, deltaTime, 76);
+STD140_SIZE(FrameConstants, 80);
+
+// Need a current GL context
+bool InitFrameConstants();
+void ShutdownFrameConstants();
+
+// Once per frame, before drawing
+void SetFrameConstants(const FrameConstants& constants);
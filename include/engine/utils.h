@@ -14,6 +14,8 @@
 #include <utility>   // for std::forward
 #include <vector>
 #include <string>
+#include <string_view>
+#include <span>
 
 // ============================
 // Basic typedefs
@@ -42,6 +44,21 @@ typedef Quat quat;
 template<typename T>
 using array = std::vector<T>; 
 
+// ============================
+// Hashing
+// ============================
+// 64-bit FNV-1a, usable at compile time for string literals
+constexpr u64 HashString(std::string_view s)
+{
+    u64 hash = 0xcbf29ce484222325ull;
+    for (char c : s)
+    {
+        hash ^= (u8)c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
 // ============================
 // Logging & Assert Macro
 // ============================
@@ -67,21 +84,103 @@ char* read_file(str path);
 // Writes buffer to file. Returns 1 on success, 0 on failure.
 int write_file(str path, const char* buffer, u64 size);
 
+// ============================
+// Memory-mapped files
+// ============================
+enum MapHint {
+    MAP_HINT_SEQUENTIAL, // read front to back once (shaders, images, fonts)
+    MAP_HINT_RANDOM,     // scattered reads (archives, lookups)
+};
+
+// Read-only view of a whole file. The view is unmapped when the object is
+// destroyed, so anything reading from `data` must not outlive it.
+struct MappedFile {
+    const u8* data = nullptr;
+    u64 size = 0;
+    bool valid = false;
+
+    intptr_t fileHandle = -1;      // win32 HANDLE or posix fd
+    void* mappingHandle = nullptr; // win32 only
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::span<const u8> Span() const { return {data, (size_t)size}; }
+    std::string_view Text() const { return {(const char*)data, (size_t)size}; }
+};
+
+// Maps `path` read-only and hints the kernel to read ahead. Empty files map
+// to a valid view with size 0. Returns an invalid view on failure.
+MappedFile MapFile(str path, MapHint hint = MAP_HINT_SEQUENTIAL);
+void UnmapFile(MappedFile* file);
+
+// ============================
+// Virtual memory
+// ============================
+// Page-granular address space management (VirtualAlloc / mmap).
+// Reserved ranges cost no physical memory until committed.
+size_t GetPageSize();
+void* ReserveMemory(size_t size);
+bool CommitMemory(void* ptr, size_t size);
+void DecommitMemory(void* ptr, size_t size);
+void ReleaseMemory(void* ptr, size_t size);
+
 // ============================
 // Simple Bump Allocator
 // ============================
+// Backed by a reserved virtual range: `capacity` bytes of address space are
+// reserved up front and pages are committed as `used` grows, so pointers
+// never move and an oversized capacity costs nothing until touched.
 struct BumpAllocator {
-    size_t capacity;
+    size_t capacity;  // reserved bytes
     size_t used;
+    size_t committed; // bytes backed by physical memory, from the start
     char* memory;
+    bool ownsMemory;  // false for sub-allocators living inside a parent
 };
 
-// Create a bump allocator with `size` bytes
+// Reserve `size` bytes of address space for a bump allocator
 BumpAllocator MakeAllocator(size_t size);
 
+// Give the reserved range back to the OS
+void ReleaseAllocator(BumpAllocator* alloc);
+
+// Create a bump allocator over `size` bytes carved out of `parent`
+BumpAllocator MakeSubAllocator(BumpAllocator* parent, size_t size);
+
 // Allocate aligned memory from the bump allocator
 void* BumpAllocAligned(BumpAllocator* alloc, size_t size, size_t align);
 
+// Drop every allocation. With `decommit`, pages beyond `keepCommitted`
+// bytes are returned to the OS, otherwise the backing memory stays hot.
+void ResetAllocator(BumpAllocator* alloc, bool decommit = false, size_t keepCommitted = 0);
+
+// Position in a bump allocator that can be rolled back to, freeing
+// everything allocated after it in one step
+struct AllocatorMarker {
+    BumpAllocator* alloc;
+    size_t used;
+};
+
+AllocatorMarker GetMarker(BumpAllocator* alloc);
+void RollbackToMarker(AllocatorMarker marker);
+
+// Rolls the allocator back to where it was when the scope was entered
+struct AllocatorScope {
+    AllocatorMarker marker;
+
+    explicit AllocatorScope(BumpAllocator* alloc) : marker(GetMarker(alloc)) {}
+    ~AllocatorScope() { RollbackToMarker(marker); }
+
+    AllocatorScope(const AllocatorScope&) = delete;
+    AllocatorScope& operator=(const AllocatorScope&) = delete;
+};
+
 // Template helper for typed allocation
 template <typename T, typename... Args>
 T* BumpAlloc(BumpAllocator* alloc, Args&&... args)
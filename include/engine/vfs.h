@@ -0,0 +1,70 @@
+#pragma once
+#include <engine/utils.h>
+#include <memory>
+
+// ============================
+// Virtual file system
+// ============================
+// Directories and packs are mounted with a priority; a path resolves to the
+// highest-priority mount that has it. Lookups go by the path's 64-bit hash
+// and their results (including misses) are cached, so loading the same asset
+// again never touches the filesystem just to find it. Paths are relative and
+// use '/' separators, e.g. "assets/shaders/scene.vert".
+
+// A path with its precomputed hash. String literals are hashed at compile
+// time; runtime strings have to be wrapped explicitly.
+struct VfsPath {
+    str path;
+    u64 hash;
+
+    template <size_t N>
+    consteval VfsPath(const char (&literal)[N])
+        : path(literal), hash(HashString(std::string_view(literal, N - 1))) {}
+
+    explicit constexpr VfsPath(str path) : path(path), hash(HashString(path)) {}
+};
+
+// Higher priority wins; equal priorities resolve to the most recent mount.
+// Returns a mount id, or -1 when the directory / pack doesn't exist or is invalid.
+i32 VfsMountDirectory(str directory, i32 priority = 0);
+i32 VfsMountPack(str packPath, i32 priority = 10);
+void VfsUnmount(i32 mountId);
+
+// Drops every mount and the lookup cache
+void ShutdownVfs();
+
+// Forgets cached lookups, e.g. after files were added to a mounted directory
+void VfsInvalidate();
+void VfsInvalidate(VfsPath path);
+
+bool VfsExists(VfsPath path);
+
+// Where `path` would live as a loose file in each mounted directory, highest
+// priority first, whether or not it exists there (for the file watcher)
+array<std::string> VfsDiskPaths(VfsPath path);
+
+// Read-only contents of a resolved file: a mapping of a loose file, a span
+// into a mounted pack, or a decompressed copy of a compressed pack entry.
+// A pack-backed view keeps the pack mapped even if it is unmounted meanwhile.
+struct VfsFile {
+    const u8* data = nullptr;
+    u64 size = 0;
+    bool valid = false;
+
+    MappedFile mapping;
+    u8* owned = nullptr;
+    std::shared_ptr<const void> pack; // the mount a pack-backed view points into
+
+    VfsFile() = default;
+    ~VfsFile();
+
+    VfsFile(VfsFile&& other) noexcept;
+    VfsFile& operator=(VfsFile&& other) noexcept;
+    VfsFile(const VfsFile&) = delete;
+    VfsFile& operator=(const VfsFile&) = delete;
+
+    std::span<const u8> Span() const { return {data, (size_t)size}; }
+    std::string_view Text() const { return {(const char*)data, (size_t)size}; }
+};
+
+VfsFile VfsOpen(VfsPath path, MapHint hint = MAP_HINT_SEQUENTIAL);
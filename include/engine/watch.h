@@ -0,0 +1,39 @@
+#pragma once
+#include <engine/utils.h>
+#include <engine/vfs.h>
+#include <functional>
+
+// ============================
+// Asset hot reload
+// ============================
+// A background thread watches the loose files behind VFS paths (inotify on
+// Linux, modification-time polling elsewhere). Bursts of change events, like
+// an editor's write + rename, are debounced into one notification per watch.
+// UpdateFileWatcher then runs the owning system's callback on the render
+// thread, between frames, so only the changed asset is rebuilt and swapped.
+//
+// Only directory mounts are watched: an asset served from a pack that
+// shadows the loose file never reloads.
+//
+// A file's directory doesn't have to exist yet: its nearest existing
+// ancestor is watched until it appears (e.g. cooked/ created by a tool while
+// the app runs), and a directory that is deleted and recreated is picked up
+// again the same way.
+#define WATCH_DEBOUNCE_MS 100 // quiet time after the last event before reloading
+#define WATCH_POLL_MS 250     // polling fallback interval
+
+typedef std::function<void()> WatchCallback;
+
+bool InitFileWatcher();
+void ShutdownFileWatcher();
+
+// Calls `callback` once whenever any of `paths` changes in a mounted
+// directory. Returns a watch id, or -1 when the watcher isn't running, so
+// asset systems can register unconditionally.
+i32 WatchAssets(const array<std::string> &paths, WatchCallback callback);
+i32 WatchAsset(VfsPath path, WatchCallback callback);
+void UnwatchAsset(i32 watchId);
+
+// Render thread, once per frame: forgets the cached lookups of changed paths
+// and runs the callbacks whose debounce window has passed
+void UpdateFileWatcher();
@@ -0,0 +1,35 @@
+#pragma once
+#include <platform/platform.h>
+#include <engine/input.h>
+
+// ============================
+// Headless backend
+// ============================
+// No window and no display: an EGL surfaceless context (llvmpipe when there
+// is no GPU) renders into an offscreen framebuffer the size passed to
+// CreateWindowPlatform, which stays fixed. Every frame reports the same
+// deltaTime and input only comes from the Inject* calls below, so a run
+// with the same assets and script produces the same frames. That holds as
+// long as the frame loop doesn't race background work: the app calls
+// FlushTextures instead of UpdateTextures here, so no frame draws a
+// placeholder that a faster machine would already have replaced.
+//
+// The app binary reads two environment variables at InitPlatform:
+//   ATLAS_HEADLESS_FRAMES  stop after this many frames (0 / unset: never)
+//   ATLAS_HEADLESS_DT      seconds per frame (default 1/60)
+#define HEADLESS_DELTA_TIME (1.0f / 60.0f)
+
+void SetHeadlessDeltaTime(float deltaTime);
+// ShouldClose turns true once `frames` frames were polled; 0 disables
+void SetHeadlessFrameLimit(u64 frames);
+u64 GetHeadlessFrame(); // frames polled so far
+
+// Synthetic input, queued in call order and applied by the next PollEvent
+void InjectKey(KeyCode key, bool down);
+void InjectMouseButton(i32 button, bool down);
+void InjectMouseMove(i32 x, i32 y);
+void InjectScroll(i32 delta);
+void InjectChar(c32 ch);
+
+// Copies the offscreen framebuffer, bottom row first, as RGBA8
+void ReadHeadlessPixels(array<u8>* rgba);
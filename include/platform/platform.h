@@ -0,0 +1,108 @@
+#pragma once
+#include <engine/utils.h>
+#include <engine/input.h>
+
+// ============================
+// Platform layer
+// ============================
+// One backend implements this, picked by CMake (ATLAS_PLATFORM): win32.cpp
+// on Windows, x11.cpp (X11 / GLX) on Linux, or headless.cpp (offscreen EGL,
+// no display). Engine code includes only this header; backend headers like
+// win32.h / headless.h add backend-specific extras.
+struct Input_
+{
+    bool keyDown[256] = {false};
+    bool keyPressed[256] = {false};
+    bool keyReleased[256] = {false};
+
+    bool mouseDown[5] = {false};
+    bool mousePressed[5] = {false};
+    bool mouseReleased[5] = {false};
+
+    // Keys / buttons whose pressed or released flag is set, so the next
+    // frame resets only those instead of every entry
+    u8 dirtyKeys[256];
+    u32 dirtyKeyCount = 0;
+    u8 dirtyButtons = 0; // one bit per mouse button
+
+    i32 mouseX = 0;
+    i32 mouseY = 0;
+    i32 prevMouseX = 0;
+    i32 prevMouseY = 0;
+    i32 scrollY = 0;
+
+    // Unaccelerated mouse motion this frame where the backend has raw input
+    // (XInput2), otherwise the cursor delta
+    vec2 rawMouseDelta;
+
+    c32 text[INPUT_TEXT_CAPACITY]; // typed this frame
+    u32 textCount = 0;
+    u32 textRead = 0; // IsKeyTypedChar position
+
+    InputEvent events[INPUT_EVENT_CAPACITY]; // ring, indexed by sequence number
+    u64 eventCount = 0;                      // recorded since startup
+    u64 frameEventStart = 0;                 // first of the last PollEvent
+
+    ivec2 screen;
+};
+
+typedef Input_ *Input;
+
+extern Input input;
+extern BumpAllocator persistentStorage;
+
+struct Event
+{
+    // Delta time
+    float deltaTime = 0.0f;
+
+    // Any input, resize or expose event arrived this poll
+    bool activity = false;
+};
+
+// Backend side of input, implemented in input.cpp: PollEvent starts with
+// BeginInputFrame and records each translated event, which updates the
+// state above and appends to the event ring. `time` is in seconds.
+void BeginInputFrame();
+void RecordKey(u8 key, bool down, double time); // a down while already down is a repeat
+void RecordMouseButton(i32 button, bool down, double time);
+void RecordMouseMove(i32 x, i32 y, double time);
+void RecordScroll(i32 delta, double time);
+void RecordChar(c32 ch, double time);
+
+bool InitPlatform();
+bool CreateWindowPlatform(str name, i32 width, i32 height);
+
+// Drains every pending window-system event once per frame
+void PollEvent(Event *event);
+bool ShouldClose();
+void DestroyPlatform();
+
+void SwapBuffersWindow();
+
+// 0 off, 1 vsync, -1 adaptive (swap late frames immediately; falls back to
+// 1 without the tear extension). False if the backend can't change it.
+bool SetSwapInterval(i32 interval);
+
+// Blocks until a window-system event arrives or `timeoutSeconds` pass
+void WaitForEvents(double timeoutSeconds);
+
+// No display: frame times are virtual, so nothing should sleep or skip frames
+bool IsHeadless();
+
+// Extension entry points the GL loader doesn't know about; needs a current context
+void* GetGLProcAddress(str name);
+
+// ============================
+// Backend helpers (platform.cpp)
+// ============================
+// Engine state every backend sets up the same way: persistent storage and
+// input, the frame arena, the I/O service and the working-directory mount.
+// InitPlatform calls InitEngineServices; DestroyPlatform calls
+// ShutdownEngineServices last, after its context and window are gone, which
+// also reports leaks in debug builds.
+void InitEngineServices();
+void ShutdownEngineServices();
+
+// Whole-word match in a space-separated extension list (GLX, WGL, EGL)
+bool HasExtension(str extensions, str name);
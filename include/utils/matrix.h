@@ -2,7 +2,7 @@
 #include <cstring>
 #include <cmath>
 #include "vector.h"
-#include "Quat.h"
+#include "quat.h"
 
 struct Mat3; // forward declaration
 
@@ -27,12 +27,8 @@ struct Mat4
     // Construct Mat4 from Mat3 + translation Vec3
     Mat4(const Mat3 &Mat3_, const Vec3 &t);
 
-    // Copy constructor
-    Mat4(const Mat4 &other)
-    {
-        for (int i = 0; i < 16; i++)
-            m[i] = other.m[i];
-    }
+    Mat4(const Mat4 &other) = default;
+    Mat4 &operator=(const Mat4 &other) = default;
     static Mat4 Identity()
     {
         Mat4 r;
@@ -2,7 +2,9 @@
 #include <cmath>
 #include "vector.h"
 
+#ifndef M_PI
 #define M_PI 3.14159265f
+#endif
 
 struct Quat
 {
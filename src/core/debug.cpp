@@ -0,0 +1,33 @@
+#include <engine/debug.h>
+#include <engine/memory.h>
+#include <engine/text.h>
+
+static float ToMB(i64 bytes)
+{
+    return (float)bytes / (1024.0f * 1024.0f);
+}
+
+void DrawMemoryOverlay(float x, float y, float scale)
+{
+    MemoryStats stats = GetMemoryStats();
+    float lineHeight = font.lineHeight * scale;
+    vec4 color = vec4(0.8f, 1.0f, 0.8f, 1.0f);
+
+    RenderText(FrameFormat("memory %.2f MB (peak %.2f MB), %llu allocs/frame",
+                           ToMB(stats.totalLiveBytes), ToMB(stats.totalPeakBytes),
+                           (unsigned long long)stats.frameAllocs),
+               x, y, scale, color);
+
+    for (int i = 0; i < MEM_TAG_COUNT; i++)
+    {
+        const MemoryTagStats &t = stats.tags[i];
+        if (!t.peakBytes)
+            continue;
+
+        y -= lineHeight;
+        RenderText(FrameFormat("  %-8s %8.2f MB  peak %8.2f MB  %6llu live  %4llu/frame",
+                               MemoryTagName((MemoryTag)i), ToMB(t.liveBytes), ToMB(t.peakBytes),
+                               (unsigned long long)t.liveAllocs, (unsigned long long)t.frameAllocs),
+                   x, y, scale, color);
+    }
+}
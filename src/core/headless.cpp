@@ -0,0 +1,238 @@
+#include <platform/headless.h>
+#include <glad/glad.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <stdlib.h>
+
+bool running = false;
+
+static EGLDisplay display = EGL_NO_DISPLAY;
+static EGLContext context = EGL_NO_CONTEXT;
+
+// Stands in for the default framebuffer; bound once and never unbound
+static u32 framebuffer = 0;
+static u32 colorTarget = 0;
+static u32 depthTarget = 0;
+
+static float deltaTime = HEADLESS_DELTA_TIME;
+static u64 frameLimit = 0;
+static u64 frame = 0;
+
+enum InjectedType : u8 { INJECT_KEY, INJECT_BUTTON, INJECT_MOVE, INJECT_SCROLL, INJECT_CHAR };
+
+struct InjectedEvent
+{
+    InjectedType type;
+    bool down;
+    i32 x, y; // key / button / char in x
+};
+
+static array<InjectedEvent> injected;
+
+// ---------------- Configuration ----------------
+void SetHeadlessDeltaTime(float dt) { deltaTime = dt; }
+void SetHeadlessFrameLimit(u64 frames) { frameLimit = frames; }
+u64 GetHeadlessFrame() { return frame; }
+
+// ---------------- Synthetic input ----------------
+void InjectKey(KeyCode key, bool down) { injected.push_back({INJECT_KEY, down, (i32)key, 0}); }
+void InjectMouseButton(i32 button, bool down) { injected.push_back({INJECT_BUTTON, down, button, 0}); }
+void InjectMouseMove(i32 x, i32 y) { injected.push_back({INJECT_MOVE, false, x, y}); }
+void InjectScroll(i32 delta) { injected.push_back({INJECT_SCROLL, false, delta, 0}); }
+void InjectChar(c32 ch) { injected.push_back({INJECT_CHAR, false, (i32)ch, 0}); }
+
+// Timestamped on the virtual clock, at the start of the frame that applies them
+static void ApplyInjected(const InjectedEvent &event, double time)
+{
+    switch (event.type)
+    {
+        case INJECT_KEY:
+            if (event.x >= 0 && event.x < 256)
+                RecordKey((u8)event.x, event.down, time);
+            return;
+        case INJECT_BUTTON: RecordMouseButton(event.x, event.down, time); return;
+        case INJECT_MOVE:   RecordMouseMove(event.x, event.y, time); return;
+        case INJECT_SCROLL: RecordScroll(event.x, time); return;
+        case INJECT_CHAR:   RecordChar((c32)event.x, time); return;
+    }
+}
+
+// ---------------- Platform Init ----------------
+bool InitPlatform()
+{
+    if (const char *frames = getenv("ATLAS_HEADLESS_FRAMES"))
+        frameLimit = strtoull(frames, nullptr, 10);
+    if (const char *dt = getenv("ATLAS_HEADLESS_DT"))
+        deltaTime = strtof(dt, nullptr);
+
+    InitEngineServices();
+    return true;
+}
+
+// ---------------- Create Context & Offscreen Target ----------------
+static EGLDisplay OpenDisplay()
+{
+    // The surfaceless platform needs neither X nor a DRM device, so it works
+    // in containers; the default display is the fallback
+    str clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay && HasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+    {
+        EGLDisplay surfaceless = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (surfaceless != EGL_NO_DISPLAY && eglInitialize(surfaceless, nullptr, nullptr))
+            return surfaceless;
+    }
+
+    EGLDisplay fallback = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (fallback != EGL_NO_DISPLAY && eglInitialize(fallback, nullptr, nullptr))
+        return fallback;
+    return EGL_NO_DISPLAY;
+}
+
+bool CreateWindowPlatform(str name, i32 width, i32 height)
+{
+    input->screen = ivec2(width, height);
+
+    display = OpenDisplay();
+    if (display == EGL_NO_DISPLAY)
+    {
+        print("Failed to initialize EGL");
+        return false;
+    }
+    if (!HasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context"))
+    {
+        print("EGL_KHR_surfaceless_context not supported!");
+        return false;
+    }
+    eglBindAPI(EGL_OPENGL_API);
+
+    // 4.6 like the windowed backends; llvmpipe may stop at 4.5
+    for (i32 minor : {6, 5})
+    {
+        EGLint attribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 4,
+            EGL_CONTEXT_MINOR_VERSION, minor,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_CONTEXT_OPENGL_DEBUG, EGL_TRUE,
+            EGL_NONE
+        };
+        context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attribs);
+        if (context != EGL_NO_CONTEXT)
+            break;
+    }
+
+    if (context == EGL_NO_CONTEXT)
+    {
+        print("Failed to create modern OpenGL context! (EGL error 0x%x)", eglGetError());
+        return false;
+    }
+
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context);
+
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+    {
+        print("Failed to initialize GLAD!");
+        return false;
+    }
+
+    glEnable(GL_DEBUG_OUTPUT);
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+
+    // Same formats the windowed backends ask for
+    glGenRenderbuffers(1, &colorTarget);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorTarget);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &depthTarget);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthTarget);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorTarget);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthTarget);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        print("Offscreen framebuffer incomplete");
+        return false;
+    }
+
+    glViewport(0, 0, width, height);
+    print("Headless %s: %dx%d, %s", name, width, height, (const char *)glGetString(GL_RENDERER));
+
+    running = true;
+    return true;
+}
+
+// ---------------- Event Handling ----------------
+void PollEvent(Event* event)
+{
+    // Fixed, not measured: simulation results don't depend on how fast the
+    // machine renders
+    event->deltaTime = deltaTime;
+
+    BeginInputFrame();
+
+    event->activity = !injected.empty();
+    for (const InjectedEvent &injectedEvent : injected)
+        ApplyInjected(injectedEvent, (double)frame * deltaTime);
+    injected.clear();
+
+    input->rawMouseDelta = vec2((float)(input->mouseX - input->prevMouseX), (float)(input->mouseY - input->prevMouseY));
+
+    frame++;
+    if (frameLimit && frame >= frameLimit)
+        running = false;
+}
+
+bool ShouldClose() { return !running; }
+
+bool IsHeadless() { return true; }
+
+// Nothing waits on a display: no swap interval, and no events to wait for
+bool SetSwapInterval(i32) { return false; }
+void WaitForEvents(double) {}
+
+// Nothing to present. Waiting for the GPU keeps frame times honest for
+// benchmarks, like a swap does once the driver's queue is full.
+void SwapBuffersWindow() { glFinish(); }
+
+void *GetGLProcAddress(str name)
+{
+    return (void *)eglGetProcAddress(name);
+}
+
+void ReadHeadlessPixels(array<u8> *rgba)
+{
+    rgba->resize((size_t)input->screen.x * input->screen.y * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, input->screen.x, input->screen.y, GL_RGBA, GL_UNSIGNED_BYTE, rgba->data());
+}
+
+void DestroyPlatform()
+{
+    running = false;
+
+    if (context != EGL_NO_CONTEXT)
+    {
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(1, &colorTarget);
+        glDeleteRenderbuffers(1, &depthTarget);
+        framebuffer = colorTarget = depthTarget = 0;
+
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display, context);
+        context = EGL_NO_CONTEXT;
+    }
+    if (display != EGL_NO_DISPLAY)
+    {
+        eglTerminate(display);
+        display = EGL_NO_DISPLAY;
+    }
+
+    injected.clear();
+    injected.shrink_to_fit();
+
+    ShutdownEngineServices();
+}
@@ -1,9 +1,21 @@
 #include <engine/utils.h>
+#include <engine/memory.h>
 #include <string.h>
 #include <stdarg.h>
+#include <algorithm>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 #include <glad/glad.h>
 #include <iostream>
 
+#define BUMP_COMMIT_STEP KB(64)
+
 void print(const char *fmt, ...)
 {
     va_list args;
@@ -58,15 +70,190 @@ int write_file(str path, const char *buffer, u64 size)
     return 1;
 }
 
-BumpAllocator MakeAllocator(size_t size)
+// ---------------- Memory-mapped files ----------------
+MappedFile MapFile(str path, MapHint hint)
 {
-    BumpAllocator alloc{};
-    alloc.memory = (char *)malloc(size);
-    alloc.capacity = size;
-    alloc.used = 0;
-    return alloc;
+    MappedFile file;
+#ifdef _WIN32
+    DWORD flags = hint == MAP_HINT_SEQUENTIAL ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size))
+    {
+        CloseHandle(handle);
+        return file;
+    }
+
+    file.fileHandle = (intptr_t)handle;
+    file.size = (u64)size.QuadPart;
+    file.valid = true;
+    if (!file.size)
+        return file; // can't map an empty file, but it is a valid one
+
+    HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view)
+    {
+        if (mapping)
+            CloseHandle(mapping);
+        UnmapFile(&file);
+        return file;
+    }
+
+    file.mappingHandle = mapping;
+    file.data = (const u8 *)view;
+#else
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return file;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return file;
+    }
+
+    file.fileHandle = fd;
+    file.size = (u64)st.st_size;
+    file.valid = true;
+    if (!file.size)
+        return file;
+
+    void *view = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED)
+    {
+        UnmapFile(&file);
+        return file;
+    }
+
+    if (hint == MAP_HINT_SEQUENTIAL)
+    {
+        madvise(view, file.size, MADV_SEQUENTIAL);
+        madvise(view, file.size, MADV_WILLNEED);
+    }
+    else
+    {
+        madvise(view, file.size, MADV_RANDOM);
+    }
+
+    file.data = (const u8 *)view;
+#endif
+    return file;
+}
+
+void UnmapFile(MappedFile *file)
+{
+#ifdef _WIN32
+    if (file->data)
+        UnmapViewOfFile(file->data);
+    if (file->mappingHandle)
+        CloseHandle((HANDLE)file->mappingHandle);
+    if (file->fileHandle != -1)
+        CloseHandle((HANDLE)file->fileHandle);
+#else
+    if (file->data)
+        munmap((void *)file->data, file->size);
+    if (file->fileHandle != -1)
+        close((int)file->fileHandle);
+#endif
+    file->data = nullptr;
+    file->size = 0;
+    file->valid = false;
+    file->fileHandle = -1;
+    file->mappingHandle = nullptr;
+}
+
+MappedFile::~MappedFile()
+{
+    UnmapFile(this);
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        UnmapFile(this);
+        data = other.data;
+        size = other.size;
+        valid = other.valid;
+        fileHandle = other.fileHandle;
+        mappingHandle = other.mappingHandle;
+
+        other.data = nullptr;
+        other.size = 0;
+        other.valid = false;
+        other.fileHandle = -1;
+        other.mappingHandle = nullptr;
+    }
+    return *this;
+}
+
+// ---------------- Virtual memory ----------------
+size_t GetPageSize()
+{
+    static size_t pageSize = 0;
+    if (!pageSize)
+    {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        pageSize = info.dwPageSize;
+#else
+        pageSize = (size_t)sysconf(_SC_PAGESIZE);
+#endif
+    }
+    return pageSize;
 }
 
+void *ReserveMemory(size_t size)
+{
+#ifdef _WIN32
+    return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void *ptr = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+#endif
+}
+
+bool CommitMemory(void *ptr, size_t size)
+{
+#ifdef _WIN32
+    return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+void DecommitMemory(void *ptr, size_t size)
+{
+#ifdef _WIN32
+    VirtualFree(ptr, size, MEM_DECOMMIT);
+#else
+    madvise(ptr, size, MADV_DONTNEED);
+    mprotect(ptr, size, PROT_NONE);
+#endif
+}
+
+void ReleaseMemory(void *ptr, size_t size)
+{
+#ifdef _WIN32
+    (void)size;
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    munmap(ptr, size);
+#endif
+}
+
+// ---------------- Bump Allocator ----------------
 inline size_t AlignForward(size_t ptr, size_t align)
 {
     size_t mod = ptr & (align - 1);
@@ -75,6 +262,41 @@ inline size_t AlignForward(size_t ptr, size_t align)
     return ptr;
 }
 
+BumpAllocator MakeAllocator(size_t size)
+{
+    BumpAllocator alloc{};
+    size = AlignForward(size, GetPageSize());
+    alloc.memory = (char *)ReserveMemory(size);
+    alloc.capacity = alloc.memory ? size : 0;
+    alloc.used = 0;
+    alloc.committed = 0;
+    alloc.ownsMemory = true;
+    return alloc;
+}
+
+void ReleaseAllocator(BumpAllocator *alloc)
+{
+    if (alloc->memory && alloc->ownsMemory)
+    {
+        ReleaseMemory(alloc->memory, alloc->capacity);
+        if (alloc->committed)
+            TrackFree(MEM_ARENA, alloc->committed);
+    }
+    *alloc = BumpAllocator{};
+}
+
+BumpAllocator MakeSubAllocator(BumpAllocator *parent, size_t size)
+{
+    // Carved out of (and committed by) the parent, so it never commits itself
+    BumpAllocator alloc{};
+    alloc.memory = (char *)BumpAllocAligned(parent, size, 64);
+    alloc.capacity = alloc.memory ? size : 0;
+    alloc.used = 0;
+    alloc.committed = alloc.capacity;
+    alloc.ownsMemory = false;
+    return alloc;
+}
+
 void *BumpAllocAligned(BumpAllocator *alloc, size_t size, size_t align)
 {
     size_t current = (size_t)alloc->memory + alloc->used;
@@ -84,10 +306,55 @@ void *BumpAllocAligned(BumpAllocator *alloc, size_t size, size_t align)
     if (newUsed > alloc->capacity)
         return nullptr;
 
+    if (newUsed > alloc->committed)
+    {
+        // Commit in large steps to keep the number of syscalls down
+        size_t step = std::max<size_t>(newUsed - alloc->committed, BUMP_COMMIT_STEP);
+        size_t target = std::min(AlignForward(alloc->committed + step, GetPageSize()), alloc->capacity);
+        if (!CommitMemory(alloc->memory + alloc->committed, target - alloc->committed))
+            return nullptr;
+        // One tracked allocation per arena, grown by each later commit
+        if (alloc->committed)
+            TrackResize(MEM_ARENA, (i64)(target - alloc->committed));
+        else
+            TrackAlloc(MEM_ARENA, target);
+        alloc->committed = target;
+    }
+
     alloc->used = newUsed;
     return (void *)aligned;
 }
 
+void ResetAllocator(BumpAllocator *alloc, bool decommit, size_t keepCommitted)
+{
+    alloc->used = 0;
+
+    if (decommit && alloc->ownsMemory)
+    {
+        size_t keep = std::min(AlignForward(keepCommitted, GetPageSize()), alloc->committed);
+        if (alloc->committed > keep)
+        {
+            DecommitMemory(alloc->memory + keep, alloc->committed - keep);
+            if (keep)
+                TrackResize(MEM_ARENA, -(i64)(alloc->committed - keep));
+            else
+                TrackFree(MEM_ARENA, alloc->committed);
+        }
+        alloc->committed = keep;
+    }
+}
+
+AllocatorMarker GetMarker(BumpAllocator *alloc)
+{
+    return AllocatorMarker{alloc, alloc->used};
+}
+
+void RollbackToMarker(AllocatorMarker marker)
+{
+    Assert(marker.used <= marker.alloc->used, "Rollback past the current allocation point");
+    marker.alloc->used = marker.used;
+}
+
 void APIENTRY glDebugOutput(GLenum source, 
                             GLenum type, 
                             unsigned int id, 
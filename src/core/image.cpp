@@ -0,0 +1,300 @@
+#include <engine/image.h>
+#include <string.h>
+#include <algorithm>
+
+// ---------------- Mips ----------------
+
+i32 MipLevelCount(i32 width, i32 height)
+{
+    i32 levels = 1;
+    for (i32 size = std::max(width, height); size > 1; size >>= 1)
+        levels++;
+    return std::min(levels, IMAGE_MAX_LEVELS);
+}
+
+i32 MipSize(i32 size, i32 level)
+{
+    return std::max(size >> level, 1);
+}
+
+void PremultiplyAlpha(u8 *pixels, size_t pixelCount)
+{
+    for (size_t i = 0; i < pixelCount; i++, pixels += 4)
+    {
+        u32 a = pixels[3];
+        pixels[0] = (u8)((pixels[0] * a + 127) / 255);
+        pixels[1] = (u8)((pixels[1] * a + 127) / 255);
+        pixels[2] = (u8)((pixels[2] * a + 127) / 255);
+    }
+}
+
+void DownsampleRGBA8(const u8 *src, i32 srcW, i32 srcH, u8 *dst)
+{
+    i32 dstW = MipSize(srcW, 1);
+    i32 dstH = MipSize(srcH, 1);
+    for (i32 y = 0; y < dstH; y++)
+    {
+        const u8 *row0 = src + (size_t)std::min(y * 2, srcH - 1) * srcW * 4;
+        const u8 *row1 = src + (size_t)std::min(y * 2 + 1, srcH - 1) * srcW * 4;
+        for (i32 x = 0; x < dstW; x++)
+        {
+            i32 x0 = std::min(x * 2, srcW - 1) * 4;
+            i32 x1 = std::min(x * 2 + 1, srcW - 1) * 4;
+            for (i32 c = 0; c < 4; c++)
+                *dst++ = (u8)((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+        }
+    }
+}
+
+// ---------------- Block compression ----------------
+
+size_t BlockCompressedSize(i32 width, i32 height, u32 blockBytes)
+{
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * blockBytes;
+}
+
+static void FetchBlock(const u8 *pixels, i32 width, i32 height, i32 bx, i32 by, u8 block[16][4])
+{
+    for (i32 y = 0; y < 4; y++)
+    {
+        i32 sy = std::min(by * 4 + y, height - 1);
+        for (i32 x = 0; x < 4; x++)
+        {
+            i32 sx = std::min(bx * 4 + x, width - 1);
+            memcpy(block[y * 4 + x], pixels + ((size_t)sy * width + sx) * 4, 4);
+        }
+    }
+}
+
+static u16 To565(const i32 c[3])
+{
+    return (u16)(((c[0] * 31 + 127) / 255) << 11 | ((c[1] * 63 + 127) / 255) << 5 | ((c[2] * 31 + 127) / 255));
+}
+
+static void From565(u16 v, i32 c[3])
+{
+    i32 r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    c[0] = (r << 3) | (r >> 2);
+    c[1] = (g << 2) | (g >> 4);
+    c[2] = (b << 3) | (b >> 2);
+}
+
+// Writes the 8-byte color part. With `allowTransparent`, texels with alpha
+// below 128 use the 3-color mode's transparent index (BC1 only).
+static void EncodeColorBlock(const u8 block[16][4], bool allowTransparent, u8 *dst)
+{
+    bool transparent[16] = {};
+    bool anyTransparent = false;
+    i32 lo[3] = {255, 255, 255};
+    i32 hi[3] = {0, 0, 0};
+    for (i32 i = 0; i < 16; i++)
+    {
+        transparent[i] = allowTransparent && block[i][3] < 128;
+        anyTransparent |= transparent[i];
+        if (transparent[i])
+            continue;
+        for (i32 c = 0; c < 3; c++)
+        {
+            lo[c] = std::min(lo[c], (i32)block[i][c]);
+            hi[c] = std::max(hi[c], (i32)block[i][c]);
+        }
+    }
+
+    if (lo[0] > hi[0])
+    {
+        // Fully transparent: color0 < color1 selects 3-color mode, index 3 everywhere
+        static const u8 clear[8] = {0, 0, 1, 0, 0xFF, 0xFF, 0xFF, 0xFF};
+        memcpy(dst, clear, sizeof(clear));
+        return;
+    }
+
+    // Flip red / blue along the diagonal that matches their correlation with green
+    i32 mid[3] = {(lo[0] + hi[0]) / 2, (lo[1] + hi[1]) / 2, (lo[2] + hi[2]) / 2};
+    i32 covRG = 0, covBG = 0;
+    for (i32 i = 0; i < 16; i++)
+    {
+        if (transparent[i])
+            continue;
+        i32 g = block[i][1] - mid[1];
+        covRG += (block[i][0] - mid[0]) * g;
+        covBG += (block[i][2] - mid[2]) * g;
+    }
+    if (covRG < 0)
+        std::swap(lo[0], hi[0]);
+    if (covBG < 0)
+        std::swap(lo[2], hi[2]);
+
+    // Inset the box a little so the endpoints aren't dominated by outliers
+    for (i32 c = 0; c < 3; c++)
+    {
+        i32 inset = (hi[c] - lo[c]) / 16;
+        lo[c] += inset;
+        hi[c] -= inset;
+    }
+
+    u16 c0 = To565(hi);
+    u16 c1 = To565(lo);
+    bool threeColor = anyTransparent;
+    if (threeColor ? c0 > c1 : c0 < c1)
+        std::swap(c0, c1);
+
+    i32 palette[4][3];
+    From565(c0, palette[0]);
+    From565(c1, palette[1]);
+    for (i32 c = 0; c < 3; c++)
+    {
+        if (threeColor)
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+        else
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+    }
+
+    u32 indices = 0;
+    if (c0 != c1 || threeColor)
+    {
+        i32 choices = threeColor ? 3 : 4;
+        for (i32 i = 0; i < 16; i++)
+        {
+            u32 best = 3;
+            if (!transparent[i])
+            {
+                i32 bestError = 1 << 30;
+                for (i32 p = 0; p < choices; p++)
+                {
+                    i32 dr = block[i][0] - palette[p][0];
+                    i32 dg = block[i][1] - palette[p][1];
+                    i32 db = block[i][2] - palette[p][2];
+                    i32 error = dr * dr + dg * dg + db * db;
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        best = p;
+                    }
+                }
+            }
+            indices |= best << (i * 2);
+        }
+    }
+
+    dst[0] = (u8)c0;
+    dst[1] = (u8)(c0 >> 8);
+    dst[2] = (u8)c1;
+    dst[3] = (u8)(c1 >> 8);
+    memcpy(dst + 4, &indices, 4);
+}
+
+static void EncodeAlphaBlock(const u8 block[16][4], u8 *dst)
+{
+    i32 a0 = 0, a1 = 255;
+    for (i32 i = 0; i < 16; i++)
+    {
+        a0 = std::max(a0, (i32)block[i][3]);
+        a1 = std::min(a1, (i32)block[i][3]);
+    }
+
+    // a0 > a1 selects the 8-value ramp: a0, a1, then 6 steps between them
+    i32 ramp[8] = {a0, a1};
+    for (i32 i = 1; i < 7; i++)
+        ramp[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+
+    u64 indices = 0;
+    if (a0 != a1)
+    {
+        for (i32 i = 0; i < 16; i++)
+        {
+            u64 best = 0;
+            i32 bestError = 256;
+            for (i32 p = 0; p < 8; p++)
+            {
+                i32 error = std::abs(block[i][3] - ramp[p]);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    best = p;
+                }
+            }
+            indices |= best << (i * 3);
+        }
+    }
+
+    dst[0] = (u8)a0;
+    dst[1] = (u8)a1;
+    for (i32 i = 0; i < 6; i++)
+        dst[2 + i] = (u8)(indices >> (i * 8));
+}
+
+void EncodeBC1(const u8 *pixels, i32 width, i32 height, u8 *dst)
+{
+    u8 block[16][4];
+    for (i32 by = 0; by < (height + 3) / 4; by++)
+    {
+        for (i32 bx = 0; bx < (width + 3) / 4; bx++)
+        {
+            FetchBlock(pixels, width, height, bx, by, block);
+            EncodeColorBlock(block, true, dst);
+            dst += BC1_BLOCK_BYTES;
+        }
+    }
+}
+
+void EncodeBC3(const u8 *pixels, i32 width, i32 height, u8 *dst)
+{
+    u8 block[16][4];
+    for (i32 by = 0; by < (height + 3) / 4; by++)
+    {
+        for (i32 bx = 0; bx < (width + 3) / 4; bx++)
+        {
+            FetchBlock(pixels, width, height, bx, by, block);
+            EncodeAlphaBlock(block, dst);
+            EncodeColorBlock(block, false, dst + 8);
+            dst += BC3_BLOCK_BYTES;
+        }
+    }
+}
+
+// ---------------- Cooked textures ----------------
+
+u32 CtexBlockBytes(u32 format)
+{
+    switch (format)
+    {
+        case CTEX_FORMAT_BC1:
+            return BC1_BLOCK_BYTES;
+        case CTEX_FORMAT_BC3:
+            return BC3_BLOCK_BYTES;
+        default:
+            return 0;
+    }
+}
+
+const CtexHeader *ParseCtex(std::span<const u8> data)
+{
+    if (data.size() < sizeof(CtexHeader))
+        return nullptr;
+
+    const CtexHeader *header = (const CtexHeader *)data.data();
+    if (header->magic != CTEX_MAGIC || header->version != CTEX_VERSION ||
+        header->format > CTEX_FORMAT_BC3 || !header->width || !header->height ||
+        header->width > 1 << 15 || header->height > 1 << 15 ||
+        !header->levelCount || header->levelCount > (u32)MipLevelCount(header->width, header->height))
+        return nullptr;
+
+    u32 blockBytes = CtexBlockBytes(header->format);
+    for (u32 level = 0; level < header->levelCount; level++)
+    {
+        i32 w = MipSize(header->width, level);
+        i32 h = MipSize(header->height, level);
+        size_t expected = blockBytes ? BlockCompressedSize(w, h, blockBytes) : (size_t)w * h * 4;
+
+        const CtexLevel &l = header->levels[level];
+        if (l.size != expected || l.offset > data.size() || l.size > data.size() - l.offset)
+            return nullptr;
+    }
+    return header;
+}
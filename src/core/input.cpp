@@ -1,5 +1,5 @@
 #include <engine/input.h>
-#include <platform/win32.h>
+#include <platform/platform.h>
 
 // ---------------- Keyboard ----------------
 bool IsKeyPressed(KeyCode keycode) {
@@ -37,6 +37,10 @@ vec2 GetMouseDelta() {
                  (float)(input->mouseY - input->prevMouseY) };
 }
 
+vec2 GetRawMouseDelta() {
+    return input->rawMouseDelta;
+}
+
 i32 GetScrollY() {
     return input->scrollY;
 }
@@ -51,10 +55,128 @@ bool GetMouseButtonUp(i32 button) {
 
 bool IsKeyTypedChar(c32* chr)
 {
-    if (input->charTyped)
+    if (input->textRead < input->textCount)
     {
-        *chr = input->typedChar;
+        *chr = input->text[input->textRead++];
         return true;
     }
     return false;
-}
\ No newline at end of file
+}
+
+std::span<const c32> GetTypedText() {
+    return std::span<const c32>(input->text, input->textCount);
+}
+
+// ---------------- Events ----------------
+u64 FrameInputCursor() {
+    return input->frameEventStart;
+}
+
+bool ReadInputEvent(u64* cursor, InputEvent* event)
+{
+    if (*cursor >= input->eventCount)
+        return false;
+    if (input->eventCount - *cursor > INPUT_EVENT_CAPACITY)
+        *cursor = input->eventCount - INPUT_EVENT_CAPACITY; // overwritten
+
+    *event = input->events[*cursor % INPUT_EVENT_CAPACITY];
+    (*cursor)++;
+    return true;
+}
+
+// ---------------- Recording (backends) ----------------
+static void PushEvent(InputEventType type, u16 code, i32 x, i32 y, double time, bool repeat = false)
+{
+    input->events[input->eventCount % INPUT_EVENT_CAPACITY] = InputEvent{type, repeat, code, x, y, time};
+    input->eventCount++;
+}
+
+// Call before setting either per-frame flag of a key
+static void MarkKeyDirty(u8 key)
+{
+    if (!input->keyPressed[key] && !input->keyReleased[key])
+        input->dirtyKeys[input->dirtyKeyCount++] = key;
+}
+
+void BeginInputFrame()
+{
+    for (u32 i = 0; i < input->dirtyKeyCount; i++)
+    {
+        u8 key = input->dirtyKeys[i];
+        input->keyPressed[key] = input->keyReleased[key] = false;
+    }
+    input->dirtyKeyCount = 0;
+
+    for (i32 button = 0; button < 5; button++)
+    {
+        if (input->dirtyButtons & (1 << button))
+            input->mousePressed[button] = input->mouseReleased[button] = false;
+    }
+    input->dirtyButtons = 0;
+
+    input->textCount = input->textRead = 0;
+    input->scrollY = 0;
+    input->rawMouseDelta = vec2(0.0f);
+
+    input->prevMouseX = input->mouseX;
+    input->prevMouseY = input->mouseY;
+    input->frameEventStart = input->eventCount;
+}
+
+void RecordKey(u8 key, bool down, double time)
+{
+    bool repeat = down && input->keyDown[key];
+    if (down)
+    {
+        if (!repeat) // first press
+        {
+            MarkKeyDirty(key);
+            input->keyPressed[key] = true;
+        }
+        input->keyDown[key] = true;
+    }
+    else
+    {
+        MarkKeyDirty(key);
+        input->keyDown[key] = false;
+        input->keyReleased[key] = true;
+    }
+    PushEvent(down ? INPUT_KEY_DOWN : INPUT_KEY_UP, key, input->mouseX, input->mouseY, time, repeat);
+}
+
+void RecordMouseButton(i32 button, bool down, double time)
+{
+    if (button < 0 || button >= 5)
+        return;
+
+    input->dirtyButtons |= 1 << button;
+    if (down)
+        input->mousePressed[button] = input->mouseDown[button] = true;
+    else
+    {
+        input->mouseDown[button] = false;
+        input->mouseReleased[button] = true;
+    }
+    PushEvent(down ? INPUT_MOUSE_DOWN : INPUT_MOUSE_UP, (u16)button, input->mouseX, input->mouseY, time);
+}
+
+void RecordMouseMove(i32 x, i32 y, double time)
+{
+    input->mouseX = x;
+    input->mouseY = y;
+    PushEvent(INPUT_MOUSE_MOVE, 0, x, y, time);
+}
+
+void RecordScroll(i32 delta, double time)
+{
+    input->scrollY += delta;
+    PushEvent(INPUT_SCROLL, 0, delta, 0, time);
+}
+
+void RecordChar(c32 ch, double time)
+{
+    // Past the per-frame queue the character is still in the event ring
+    if (input->textCount < INPUT_TEXT_CAPACITY)
+        input->text[input->textCount++] = ch;
+    PushEvent(INPUT_CHAR, 0, (i32)ch, 0, time);
+}
@@ -0,0 +1,683 @@
+#include <engine/io.h>
+#include <engine/memory.h>
+
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef ATLAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+struct IoService
+{
+    std::mutex lock;
+    std::condition_variable wake;
+    std::deque<IoHandle> queues[IO_PRIORITY_COUNT];
+    std::vector<std::thread> threads;
+    u32 workerCount = 0;
+    bool running = false;
+    bool started = false; // threads are spawned by the first read
+    bool uring = false;
+};
+
+static IoService io;
+
+IoRequest::~IoRequest()
+{
+    if (ownsBuffer)
+        TrackedFree(buffer);
+}
+
+// ---------------- File primitives ----------------
+static intptr_t OpenForRead(str path, u64 *fileSize)
+{
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return -1;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size))
+    {
+        CloseHandle(handle);
+        return -1;
+    }
+    *fileSize = (u64)size.QuadPart;
+    return (intptr_t)handle;
+#else
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    *fileSize = (u64)st.st_size;
+    return fd;
+#endif
+}
+
+static void CloseFile(intptr_t file)
+{
+#ifdef _WIN32
+    CloseHandle((HANDLE)file);
+#else
+    close((int)file);
+#endif
+}
+
+// Blocking positional read, returns bytes read or -1
+static i64 ReadAt(intptr_t file, u8 *dst, u64 size, u64 offset)
+{
+#ifdef _WIN32
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
+    DWORD read = 0;
+    if (!ReadFile((HANDLE)file, dst, (DWORD)size, &read, &overlapped))
+        return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+    return read;
+#else
+    ssize_t read = pread((int)file, dst, size, (off_t)offset);
+    return read < 0 ? -1 : read;
+#endif
+}
+
+// Opens the file and sizes/allocates the destination. False on failure.
+static bool PrepareRequest(IoRequest &req)
+{
+    u64 fileSize = 0;
+    req.file = OpenForRead(req.path.c_str(), &fileSize);
+    if (req.file == -1)
+        return false;
+
+    if (req.offset > fileSize)
+        req.offset = fileSize;
+    if (!req.size || req.offset + req.size > fileSize)
+        req.size = fileSize - req.offset;
+
+    if (!req.buffer)
+    {
+        req.buffer = (u8 *)TrackedMalloc(MEM_ASSETS, req.size + 1);
+        if (!req.buffer)
+            return false;
+        req.buffer[req.size] = 0;
+        req.ownsBuffer = true;
+    }
+    return true;
+}
+
+static void CompleteRequest(IoRequest &req, IoStatus status)
+{
+    if (req.file != -1)
+    {
+        CloseFile(req.file);
+        req.file = -1;
+    }
+
+    if (req.onComplete)
+        req.onComplete(req);
+
+    req.status.store(status, std::memory_order_release);
+    req.status.notify_all();
+}
+
+// Completes requests collected under the lock. Caller must not hold it:
+// onComplete may queue or cancel other reads.
+static void CompleteCancelled(std::vector<IoHandle> &cancelled)
+{
+    for (IoHandle &req : cancelled)
+        CompleteRequest(*req, IO_CANCELLED);
+    cancelled.clear();
+}
+
+// Highest priority request first. Cancelled ones are moved to `cancelled`
+// for the caller to complete after unlocking. Caller holds the lock.
+static IoHandle PopRequest(std::vector<IoHandle> &cancelled)
+{
+    for (auto &queue : io.queues)
+    {
+        while (!queue.empty())
+        {
+            IoHandle req = std::move(queue.front());
+            queue.pop_front();
+            if (req->cancelRequested.load(std::memory_order_relaxed))
+            {
+                cancelled.push_back(std::move(req));
+                continue;
+            }
+            return req;
+        }
+    }
+    return nullptr;
+}
+
+// ---------------- Thread pool backend ----------------
+static void WorkerThread()
+{
+    std::vector<IoHandle> cancelled;
+    for (;;)
+    {
+        IoHandle req;
+        {
+            std::unique_lock<std::mutex> guard(io.lock);
+            io.wake.wait(guard, [&] { return !io.running || (req = PopRequest(cancelled)) || !cancelled.empty(); });
+        }
+        CompleteCancelled(cancelled);
+        if (!req)
+        {
+            if (!io.running)
+                return;
+            continue;
+        }
+
+        req->status.store(IO_READING, std::memory_order_relaxed);
+        if (!PrepareRequest(*req))
+        {
+            CompleteRequest(*req, IO_FAILED);
+            continue;
+        }
+
+        IoStatus status = IO_DONE;
+        while (req->bytesRead < req->size)
+        {
+            if (req->cancelRequested.load(std::memory_order_relaxed))
+            {
+                status = IO_CANCELLED;
+                break;
+            }
+
+            u64 chunk = std::min<u64>(req->size - req->bytesRead, IO_CHUNK_SIZE);
+            i64 read = ReadAt(req->file, req->buffer + req->bytesRead, chunk, req->offset + req->bytesRead);
+            if (read < 0)
+            {
+                status = IO_FAILED;
+                break;
+            }
+            if (read == 0)
+                break; // file shrank under us
+            req->bytesRead += read;
+        }
+        CompleteRequest(*req, status);
+    }
+}
+
+// ---------------- io_uring backend ----------------
+#ifdef ATLAS_IO_URING
+struct Uring
+{
+    int fd = -1;
+    u32 entries = 0;
+
+    u32 *sqHead, *sqTail, *sqMask, *sqArray;
+    io_uring_sqe *sqes;
+    u32 *cqHead, *cqTail, *cqMask;
+    io_uring_cqe *cqes;
+
+    void *sqRing = nullptr;
+    void *cqRing = nullptr;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    size_t sqesSize = 0;
+    u32 pendingSubmit = 0;
+};
+
+// One slot per possible in-flight read
+struct UringChunk
+{
+    IoHandle req;
+    u64 offset; // relative to req->offset
+    u32 length;
+    iovec iov;  // READV rather than READ keeps this working on pre-5.6 kernels
+};
+
+static Uring ring;
+
+static bool UringInit(u32 entries)
+{
+    io_uring_params params = {};
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0)
+        return false;
+
+    ring.fd = fd;
+    ring.entries = params.sq_entries;
+    ring.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(u32);
+    ring.cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single)
+        ring.sqRingSize = ring.cqRingSize = std::max(ring.sqRingSize, ring.cqRingSize);
+
+    ring.sqRing = mmap(nullptr, ring.sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring.sqRing == MAP_FAILED)
+    {
+        close(fd);
+        return false;
+    }
+
+    ring.cqRing = single ? ring.sqRing
+                         : mmap(nullptr, ring.cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    ring.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    ring.sqes = (io_uring_sqe *)mmap(nullptr, ring.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring.cqRing == MAP_FAILED || ring.sqes == MAP_FAILED)
+    {
+        munmap(ring.sqRing, ring.sqRingSize);
+        if (!single && ring.cqRing != MAP_FAILED)
+            munmap(ring.cqRing, ring.cqRingSize);
+        close(fd);
+        return false;
+    }
+
+    u8 *sq = (u8 *)ring.sqRing;
+    ring.sqHead = (u32 *)(sq + params.sq_off.head);
+    ring.sqTail = (u32 *)(sq + params.sq_off.tail);
+    ring.sqMask = (u32 *)(sq + params.sq_off.ring_mask);
+    ring.sqArray = (u32 *)(sq + params.sq_off.array);
+
+    u8 *cq = (u8 *)ring.cqRing;
+    ring.cqHead = (u32 *)(cq + params.cq_off.head);
+    ring.cqTail = (u32 *)(cq + params.cq_off.tail);
+    ring.cqMask = (u32 *)(cq + params.cq_off.ring_mask);
+    ring.cqes = (io_uring_cqe *)(cq + params.cq_off.cqes);
+    return true;
+}
+
+static void UringDestroy()
+{
+    munmap(ring.sqes, ring.sqesSize);
+    if (ring.cqRing != ring.sqRing)
+        munmap(ring.cqRing, ring.cqRingSize);
+    munmap(ring.sqRing, ring.sqRingSize);
+    close(ring.fd);
+    ring = Uring{};
+}
+
+static void UringPushRead(int fd, const iovec *iov, u64 offset, u64 userData)
+{
+    u32 tail = *ring.sqTail;
+    u32 index = tail & *ring.sqMask;
+
+    io_uring_sqe &sqe = ring.sqes[index];
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_READV;
+    sqe.fd = fd;
+    sqe.addr = (u64)(uintptr_t)iov;
+    sqe.len = 1;
+    sqe.off = offset;
+    sqe.user_data = userData;
+
+    ring.sqArray[index] = index;
+    __atomic_store_n(ring.sqTail, tail + 1, __ATOMIC_RELEASE);
+    ring.pendingSubmit++;
+}
+
+static int UringEnter(u32 minComplete)
+{
+    u32 flags = minComplete ? IORING_ENTER_GETEVENTS : 0;
+    int submitted = (int)syscall(__NR_io_uring_enter, ring.fd, ring.pendingSubmit, minComplete, flags, nullptr, 0);
+    if (submitted > 0)
+        ring.pendingSubmit -= submitted;
+    return submitted;
+}
+
+// Puts a request back in its queue to be read again from the start
+static void RequeueRequest(const IoHandle &req)
+{
+    if (req->file != -1)
+    {
+        CloseFile(req->file);
+        req->file = -1;
+    }
+    req->bytesRead = 0;
+    req->submitted = 0;
+    req->inFlight = 0;
+    req->endOfFile = false;
+    req->status.store(IO_PENDING, std::memory_order_relaxed);
+    io.queues[req->priority].push_front(req);
+}
+
+// The ring stopped working. Chunks the kernel already took still write into
+// request buffers, so they are all reaped before any request completes; then
+// the ring is torn down and the active requests go back to the queues for
+// this thread to serve as a plain worker.
+static void UringFallback(std::vector<IoHandle> &active, u32 inFlight)
+{
+    u32 inKernel = inFlight - ring.pendingSubmit;
+    while (inKernel)
+    {
+        int reaped = (int)syscall(__NR_io_uring_enter, ring.fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (reaped < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            print("io_uring: %u reads can't be reaped (%d)", inKernel, errno);
+            break;
+        }
+
+        u32 head = *ring.cqHead;
+        u32 tail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail && inKernel; head++)
+            inKernel--;
+        __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+    }
+    UringDestroy();
+
+    std::vector<IoHandle> finished;
+    {
+        std::lock_guard<std::mutex> guard(io.lock);
+        io.uring = false;
+        // Reverse, so pushing to the front keeps their order
+        for (auto it = active.rbegin(); it != active.rend(); ++it)
+        {
+            IoHandle &req = *it;
+            if (req->failed || req->cancelRequested.load(std::memory_order_relaxed) || !io.running)
+                finished.push_back(std::move(req));
+            else
+                RequeueRequest(req);
+        }
+    }
+    active.clear();
+
+    for (IoHandle &req : finished)
+        CompleteRequest(*req, req->failed ? IO_FAILED : IO_CANCELLED);
+}
+
+static void UringThread()
+{
+    UringChunk chunks[IO_QUEUE_DEPTH];
+    u32 freeSlots[IO_QUEUE_DEPTH];
+    u32 freeCount = IO_QUEUE_DEPTH;
+    for (u32 i = 0; i < IO_QUEUE_DEPTH; i++)
+        freeSlots[i] = IO_QUEUE_DEPTH - 1 - i;
+
+    std::vector<IoHandle> active; // opened files still being read
+    std::vector<IoHandle> cancelled;
+    u32 inFlight = 0;
+
+    auto submitChunk = [&](const IoHandle &req, u64 offset, u32 length)
+    {
+        u32 slot = freeSlots[--freeCount];
+        chunks[slot] = UringChunk{req, offset, length, iovec{req->buffer + offset, length}};
+        UringPushRead((int)req->file, &chunks[slot].iov, req->offset + offset, slot);
+        req->inFlight++;
+        inFlight++;
+    };
+
+    auto finishIfIdle = [&](IoRequest &req) -> bool
+    {
+        bool cancelled = req.cancelRequested.load(std::memory_order_relaxed);
+        bool stopped = req.failed || cancelled || req.endOfFile || req.submitted >= req.size;
+        if (!stopped || req.inFlight)
+            return false;
+        CompleteRequest(req, req.failed ? IO_FAILED : cancelled ? IO_CANCELLED : IO_DONE);
+        return true;
+    };
+
+    for (;;)
+    {
+        // 1. Pull new requests while there is room for more open files
+        {
+            std::unique_lock<std::mutex> guard(io.lock);
+            if (!inFlight && active.empty())
+                io.wake.wait(guard, [] {
+                    if (!io.running)
+                        return true;
+                    for (auto &queue : io.queues)
+                        if (!queue.empty())
+                            return true;
+                    return false;
+                });
+            if (!io.running && !inFlight)
+                break;
+            if (!io.running)
+            {
+                // Shutting down: let in-flight chunks drain, start nothing new
+                for (IoHandle &req : active)
+                    req->cancelRequested.store(true, std::memory_order_relaxed);
+            }
+
+            while (io.running && active.size() < IO_MAX_ACTIVE_FILES)
+            {
+                IoHandle req = PopRequest(cancelled);
+                if (!req)
+                    break;
+                active.push_back(std::move(req));
+            }
+        }
+        CompleteCancelled(cancelled);
+
+        // 2. Open new files and hand out chunks, highest priority first
+        std::stable_sort(active.begin(), active.end(),
+                         [](const IoHandle &a, const IoHandle &b) { return a->priority < b->priority; });
+        for (size_t i = 0; i < active.size();)
+        {
+            IoHandle &req = active[i];
+            if (req->status.load(std::memory_order_relaxed) == IO_PENDING)
+            {
+                req->status.store(IO_READING, std::memory_order_relaxed);
+                if (!PrepareRequest(*req))
+                    req->failed = true;
+            }
+
+            while (freeCount && !req->failed && !req->cancelRequested.load(std::memory_order_relaxed) &&
+                   req->submitted < req->size)
+            {
+                u32 length = (u32)std::min<u64>(req->size - req->submitted, IO_CHUNK_SIZE);
+                submitChunk(req, req->submitted, length);
+                req->submitted += length;
+            }
+
+            if (finishIfIdle(*req))
+                active.erase(active.begin() + i);
+            else
+                i++;
+        }
+
+        if (!inFlight)
+            continue;
+
+        // 3. Submit and wait for at least one completion
+        if (UringEnter(1) < 0 && errno != EINTR && errno != EBUSY)
+        {
+            print("io_uring_enter failed (%d), falling back to the thread pool", errno);
+            UringFallback(active, inFlight);
+            WorkerThread();
+            return;
+        }
+
+        u32 head = *ring.cqHead;
+        u32 tail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++)
+        {
+            io_uring_cqe &cqe = ring.cqes[head & *ring.cqMask];
+            u32 slot = (u32)cqe.user_data;
+            UringChunk chunk = std::move(chunks[slot]);
+            freeSlots[freeCount++] = slot;
+            inFlight--;
+
+            IoRequest &req = *chunk.req;
+            req.inFlight--;
+            if (cqe.res < 0)
+            {
+                req.failed = true;
+            }
+            else if (cqe.res == 0)
+            {
+                req.endOfFile = true;
+            }
+            else
+            {
+                req.bytesRead += cqe.res;
+                if ((u32)cqe.res < chunk.length && !req.cancelRequested.load(std::memory_order_relaxed))
+                {
+                    // Short read, queue the remainder of this chunk again
+                    submitChunk(chunk.req, chunk.offset + cqe.res, chunk.length - cqe.res);
+                }
+            }
+        }
+        __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+
+        for (size_t i = 0; i < active.size();)
+        {
+            if (finishIfIdle(*active[i]))
+                active.erase(active.begin() + i);
+            else
+                i++;
+        }
+    }
+
+    for (IoHandle &req : active)
+        CompleteRequest(*req, IO_CANCELLED);
+}
+#endif
+
+// ---------------- Service ----------------
+bool InitIoService(u32 workerCount)
+{
+    std::lock_guard<std::mutex> guard(io.lock);
+    if (io.running)
+        return true;
+
+    io.running = true;
+    io.workerCount = std::max(workerCount, 1u);
+    return true;
+}
+
+// A program that never reads costs no threads. Caller holds the lock.
+static void StartIoThreads()
+{
+    if (io.started)
+        return;
+    io.started = true;
+
+#ifdef ATLAS_IO_URING
+    if (UringInit(IO_QUEUE_DEPTH))
+    {
+        io.uring = true;
+        io.threads.emplace_back(UringThread);
+        return;
+    }
+#endif
+
+    for (u32 i = 0; i < io.workerCount; i++)
+        io.threads.emplace_back(WorkerThread);
+}
+
+void ShutdownIoService()
+{
+    std::vector<IoHandle> cancelled;
+    {
+        std::lock_guard<std::mutex> guard(io.lock);
+        if (!io.running)
+            return;
+        io.running = false;
+
+        for (auto &queue : io.queues)
+        {
+            for (IoHandle &req : queue)
+                cancelled.push_back(std::move(req));
+            queue.clear();
+        }
+    }
+    io.wake.notify_all();
+    CompleteCancelled(cancelled);
+
+    for (std::thread &thread : io.threads)
+        thread.join();
+    io.threads.clear();
+    io.started = false;
+
+#ifdef ATLAS_IO_URING
+    if (io.uring)
+        UringDestroy();
+#endif
+    io.uring = false;
+}
+
+str IoBackendName()
+{
+    return io.uring ? "io_uring" : "thread pool";
+}
+
+IoHandle IoRead(str path, IoPriority priority, u64 offset, u64 size, void *buffer, std::function<void(IoRequest &)> onComplete)
+{
+    IoHandle req = std::make_shared<IoRequest>();
+    req->path = path;
+    req->offset = offset;
+    req->size = size;
+    req->buffer = (u8 *)buffer;
+    req->priority = priority;
+    req->onComplete = std::move(onComplete);
+
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> guard(io.lock);
+        if (io.running)
+        {
+            StartIoThreads();
+            io.queues[priority].push_back(req);
+            queued = true;
+        }
+    }
+    if (!queued)
+    {
+        CompleteRequest(*req, IO_CANCELLED);
+        return req;
+    }
+    io.wake.notify_one();
+    return req;
+}
+
+bool IoIsDone(const IoHandle &handle)
+{
+    return handle->status.load(std::memory_order_acquire) >= IO_DONE;
+}
+
+IoStatus IoWait(const IoHandle &handle)
+{
+    for (;;)
+    {
+        IoStatus status = handle->status.load(std::memory_order_acquire);
+        if (status >= IO_DONE)
+            return status;
+        handle->status.wait(status, std::memory_order_acquire);
+    }
+}
+
+void IoCancel(const IoHandle &handle)
+{
+    handle->cancelRequested.store(true, std::memory_order_relaxed);
+
+    // Still queued: complete it now rather than when a worker reaches it
+    bool dequeued = false;
+    {
+        std::lock_guard<std::mutex> guard(io.lock);
+        auto &queue = io.queues[handle->priority];
+        auto it = std::find(queue.begin(), queue.end(), handle);
+        if (it != queue.end())
+        {
+            queue.erase(it);
+            dequeued = true;
+        }
+    }
+    if (dequeued)
+        CompleteRequest(*handle, IO_CANCELLED);
+}
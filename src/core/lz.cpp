@@ -0,0 +1,595 @@
+#include <engine/lz.h>
+#include <string.h>
+#include <algorithm>
+#include <bit>
+
+#define LZ_MIN_MATCH 4
+#define LZ_LAST_LITERALS 5  // a block always ends with at least this many literals
+#define LZ_MF_LIMIT 12      // no match may start closer than this to the end
+#define LZ_MAX_OFFSET 65535
+#define LZ_HASH_LOG_MIN 10
+#define LZ_HASH_LOG_MAX 16
+#define LZ_SKIP_TRIGGER 6   // step grows by 1 every 2^6 bytes without a match
+
+// ---------------- Helpers ----------------
+
+static inline u32 Read32(const u8 *p)
+{
+    u32 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline u64 Read64(const u8 *p)
+{
+    u64 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void Write32(u8 *p, u32 v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline u32 HashSequence(u32 sequence, u32 hashLog)
+{
+    return (sequence * 2654435761u) >> (32 - hashLog);
+}
+
+// Length of the common prefix of a and b, reading a no further than aLimit
+static inline size_t MatchLength(const u8 *a, const u8 *b, const u8 *aLimit)
+{
+    const u8 *start = a;
+    while (a + 8 <= aLimit)
+    {
+        u64 diff = Read64(a) ^ Read64(b);
+        if (diff)
+            return (a - start) + (std::countr_zero(diff) >> 3);
+        a += 8;
+        b += 8;
+    }
+    while (a < aLimit && *a == *b)
+    {
+        a++;
+        b++;
+    }
+    return a - start;
+}
+
+// Copies in 16-byte steps and may write up to 15 bytes past dst + size; the
+// caller guarantees the room and, for overlapping copies, src <= dst - 16
+static inline void WildCopy16(u8 *dst, const u8 *src, size_t size)
+{
+    u8 *end = dst + size;
+    do
+    {
+        memcpy(dst, src, 16);
+        dst += 16;
+        src += 16;
+    } while (dst < end);
+}
+
+static inline u8 *WriteLength(u8 *op, size_t length)
+{
+    while (length >= 255)
+    {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (u8)length;
+    return op;
+}
+
+// ---------------- Block codec ----------------
+
+size_t LzCompressBound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+static u8 *WriteSequence(u8 *op, const u8 *literals, size_t literalCount, u32 offset, size_t matchLength)
+{
+    u8 *token = op++;
+    size_t ml = matchLength - LZ_MIN_MATCH;
+
+    *token = (u8)((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(ml, 15));
+    if (literalCount >= 15)
+        op = WriteLength(op, literalCount - 15);
+
+    memcpy(op, literals, literalCount);
+    op += literalCount;
+
+    op[0] = (u8)offset;
+    op[1] = (u8)(offset >> 8);
+    op += 2;
+
+    if (ml >= 15)
+        op = WriteLength(op, ml - 15);
+    return op;
+}
+
+static u8 *WriteLastLiterals(u8 *op, const u8 *literals, size_t literalCount)
+{
+    *op++ = (u8)(std::min<size_t>(literalCount, 15) << 4);
+    if (literalCount >= 15)
+        op = WriteLength(op, literalCount - 15);
+    memcpy(op, literals, literalCount);
+    return op + literalCount;
+}
+
+size_t LzCompress(const u8 *src, size_t srcSize, u8 *dst, size_t dstCapacity)
+{
+    if (dstCapacity < LzCompressBound(srcSize))
+        return 0;
+
+    u8 *op = dst;
+    if (srcSize < LZ_MF_LIMIT + 1)
+        return WriteLastLiterals(op, src, srcSize) - dst;
+
+    // Size the table to the input so small blocks don't pay for a 256 KB clear
+    u32 hashLog = LZ_HASH_LOG_MIN;
+    while (hashLog < LZ_HASH_LOG_MAX && ((size_t)1 << hashLog) < srcSize)
+        hashLog++;
+
+    static thread_local u32 table[1 << LZ_HASH_LOG_MAX];
+    memset(table, 0, sizeof(u32) << hashLog);
+
+    const u8 *ip = src;
+    const u8 *anchor = src;
+    const u8 *mfLimit = src + srcSize - LZ_MF_LIMIT;
+    const u8 *matchLimit = src + srcSize - LZ_LAST_LITERALS;
+    u32 searchCount = 1 << LZ_SKIP_TRIGGER;
+
+    while (ip < mfLimit)
+    {
+        u32 sequence = Read32(ip);
+        u32 h = HashSequence(sequence, hashLog);
+        const u8 *ref = src + table[h];
+        table[h] = (u32)(ip - src);
+
+        if (ref >= ip || ip - ref > LZ_MAX_OFFSET || Read32(ref) != sequence)
+        {
+            // Skip ahead faster through data that doesn't compress
+            ip += searchCount++ >> LZ_SKIP_TRIGGER;
+            continue;
+        }
+        searchCount = 1 << LZ_SKIP_TRIGGER;
+
+        while (ip > anchor && ref > src && ip[-1] == ref[-1])
+        {
+            ip--;
+            ref--;
+        }
+
+        size_t length = LZ_MIN_MATCH + MatchLength(ip + LZ_MIN_MATCH, ref + LZ_MIN_MATCH, matchLimit);
+        op = WriteSequence(op, anchor, ip - anchor, (u32)(ip - ref), length);
+        ip += length;
+        anchor = ip;
+
+        // Seed the table inside the match so the next search has a candidate
+        if (ip < mfLimit)
+            table[HashSequence(Read32(ip - 2), hashLog)] = (u32)(ip - 2 - src);
+    }
+
+    op = WriteLastLiterals(op, anchor, src + srcSize - anchor);
+    return op - dst;
+}
+
+i64 LzDecompress(const u8 *src, size_t srcSize, u8 *dst, size_t dstCapacity)
+{
+    const u8 *ip = src;
+    const u8 *iend = src + srcSize;
+    u8 *op = dst;
+    u8 *oend = dst + dstCapacity;
+
+    while (ip < iend)
+    {
+        u32 token = *ip++;
+
+        size_t literalCount = token >> 4;
+        if (literalCount == 15)
+        {
+            u8 b;
+            do
+            {
+                if (ip >= iend)
+                    return -1;
+                b = *ip++;
+                literalCount += b;
+            } while (b == 255);
+        }
+
+        if (literalCount > (size_t)(iend - ip) || literalCount > (size_t)(oend - op))
+            return -1;
+        if (literalCount + 16 <= (size_t)(iend - ip) && literalCount + 16 <= (size_t)(oend - op))
+            WildCopy16(op, ip, literalCount);
+        else
+            memcpy(op, ip, literalCount);
+        ip += literalCount;
+        op += literalCount;
+
+        // The last sequence has literals only
+        if (ip == iend)
+            break;
+
+        if (iend - ip < 2)
+            return -1;
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst))
+            return -1;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15)
+        {
+            u8 b;
+            do
+            {
+                if (ip >= iend)
+                    return -1;
+                b = *ip++;
+                matchLength += b;
+            } while (b == 255);
+        }
+        matchLength += LZ_MIN_MATCH;
+
+        if (matchLength > (size_t)(oend - op))
+            return -1;
+
+        const u8 *match = op - offset;
+        if (offset >= 16 && matchLength + 16 <= (size_t)(oend - op))
+        {
+            WildCopy16(op, match, matchLength);
+        }
+        else if (offset == 1)
+        {
+            memset(op, *match, matchLength);
+        }
+        else if (offset >= 8 && matchLength + 8 <= (size_t)(oend - op))
+        {
+            u8 *end = op + matchLength;
+            for (u8 *d = op; d < end; d += 8, match += 8)
+                memcpy(d, match, 8);
+        }
+        else
+        {
+            // Short repeating pattern: every copy doubles the periodic run that
+            // starts at `match`, so chunks never overlap and stay in phase
+            u8 *d = op;
+            u8 *end = op + matchLength;
+            while (d < end)
+            {
+                size_t n = std::min<size_t>(d - match, end - d);
+                memcpy(d, match, n);
+                d += n;
+            }
+        }
+        op += matchLength;
+    }
+
+    return op - dst;
+}
+
+// ---------------- XXH32 ----------------
+
+#define XXH_PRIME1 2654435761u
+#define XXH_PRIME2 2246822519u
+#define XXH_PRIME3 3266489917u
+#define XXH_PRIME4 668265263u
+#define XXH_PRIME5 374761393u
+
+static inline u32 Rotl32(u32 x, int r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+static inline u32 XxhRound(u32 acc, u32 input)
+{
+    acc += input * XXH_PRIME2;
+    acc = Rotl32(acc, 13);
+    return acc * XXH_PRIME1;
+}
+
+static u32 XxhFinalize(u32 h, const u8 *p, size_t size)
+{
+    while (size >= 4)
+    {
+        h += Read32(p) * XXH_PRIME3;
+        h = Rotl32(h, 17) * XXH_PRIME4;
+        p += 4;
+        size -= 4;
+    }
+    while (size--)
+    {
+        h += (*p++) * XXH_PRIME5;
+        h = Rotl32(h, 11) * XXH_PRIME1;
+    }
+
+    h ^= h >> 15;
+    h *= XXH_PRIME2;
+    h ^= h >> 13;
+    h *= XXH_PRIME3;
+    h ^= h >> 16;
+    return h;
+}
+
+void Xxh32Begin(Xxh32State *state, u32 seed)
+{
+    *state = {};
+    state->seed = seed;
+    state->v[0] = seed + XXH_PRIME1 + XXH_PRIME2;
+    state->v[1] = seed + XXH_PRIME2;
+    state->v[2] = seed;
+    state->v[3] = seed - XXH_PRIME1;
+}
+
+void Xxh32Update(Xxh32State *state, const void *data, size_t size)
+{
+    const u8 *p = (const u8 *)data;
+    state->total += size;
+
+    if (state->buffered + size < 16)
+    {
+        memcpy(state->buffer + state->buffered, p, size);
+        state->buffered += (u32)size;
+        return;
+    }
+
+    if (state->buffered)
+    {
+        u32 fill = 16 - state->buffered;
+        memcpy(state->buffer + state->buffered, p, fill);
+        for (int i = 0; i < 4; i++)
+            state->v[i] = XxhRound(state->v[i], Read32(state->buffer + i * 4));
+        p += fill;
+        size -= fill;
+        state->buffered = 0;
+    }
+
+    u32 v0 = state->v[0], v1 = state->v[1], v2 = state->v[2], v3 = state->v[3];
+    while (size >= 16)
+    {
+        v0 = XxhRound(v0, Read32(p));
+        v1 = XxhRound(v1, Read32(p + 4));
+        v2 = XxhRound(v2, Read32(p + 8));
+        v3 = XxhRound(v3, Read32(p + 12));
+        p += 16;
+        size -= 16;
+    }
+    state->v[0] = v0;
+    state->v[1] = v1;
+    state->v[2] = v2;
+    state->v[3] = v3;
+
+    memcpy(state->buffer, p, size);
+    state->buffered = (u32)size;
+}
+
+u32 Xxh32End(const Xxh32State *state)
+{
+    u32 h;
+    if (state->total >= 16)
+        h = Rotl32(state->v[0], 1) + Rotl32(state->v[1], 7) + Rotl32(state->v[2], 12) + Rotl32(state->v[3], 18);
+    else
+        h = state->seed + XXH_PRIME5;
+
+    h += (u32)state->total;
+    return XxhFinalize(h, state->buffer, state->buffered);
+}
+
+u32 XXH32(const void *data, size_t size, u32 seed)
+{
+    Xxh32State state;
+    Xxh32Begin(&state, seed);
+    Xxh32Update(&state, data, size);
+    return Xxh32End(&state);
+}
+
+// ---------------- Frames ----------------
+
+static bool FlushBlock(LzStreamWriter *writer)
+{
+    if (!writer->fill)
+        return true;
+
+    size_t packed = LzCompress(writer->block.data(), writer->fill, writer->scratch.data() + 4, writer->scratch.size() - 4);
+
+    // Store incompressible blocks raw so decoding them is a plain copy
+    const u8 *payload = writer->scratch.data() + 4;
+    u32 header = (u32)packed;
+    if (packed == 0 || packed >= writer->fill)
+    {
+        payload = writer->block.data();
+        packed = writer->fill;
+        header = (u32)packed | LZ_BLOCK_UNCOMPRESSED;
+    }
+
+    u8 blockHeader[4];
+    Write32(blockHeader, header);
+    writer->fill = 0;
+    return writer->sink(blockHeader, 4) && writer->sink(payload, packed);
+}
+
+bool LzStreamBegin(LzStreamWriter *writer, LzSink sink, u32 blockSize, u64 contentSize)
+{
+    blockSize = std::clamp<u32>(blockSize, KB(64), MB(64));
+
+    writer->sink = std::move(sink);
+    writer->blockSize = blockSize;
+    writer->block.resize(blockSize);
+    writer->scratch.resize(LzCompressBound(blockSize) + 4);
+    writer->fill = 0;
+    writer->failed = false;
+    Xxh32Begin(&writer->hash);
+
+    LzFrameHeader header = {LZ_FRAME_MAGIC, blockSize, contentSize};
+    writer->failed = !writer->sink((const u8 *)&header, sizeof(header));
+    return !writer->failed;
+}
+
+bool LzStreamWrite(LzStreamWriter *writer, const void *data, size_t size)
+{
+    if (writer->failed)
+        return false;
+
+    const u8 *p = (const u8 *)data;
+    Xxh32Update(&writer->hash, p, size);
+
+    while (size)
+    {
+        size_t n = std::min(size, writer->blockSize - writer->fill);
+        memcpy(writer->block.data() + writer->fill, p, n);
+        writer->fill += n;
+        p += n;
+        size -= n;
+
+        if (writer->fill == writer->blockSize && !FlushBlock(writer))
+        {
+            writer->failed = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LzStreamEnd(LzStreamWriter *writer)
+{
+    if (!writer->failed && FlushBlock(writer))
+    {
+        u8 footer[8];
+        Write32(footer, 0);
+        Write32(footer + 4, Xxh32End(&writer->hash));
+        writer->failed = !writer->sink(footer, sizeof(footer));
+    }
+    else
+    {
+        writer->failed = true;
+    }
+
+    writer->block = {};
+    writer->scratch = {};
+    return !writer->failed;
+}
+
+size_t LzFrameBound(size_t size, u32 blockSize)
+{
+    blockSize = std::clamp<u32>(blockSize, KB(64), MB(64));
+    size_t blocks = (size + blockSize - 1) / blockSize;
+    return sizeof(LzFrameHeader) + blocks * 4 + LzCompressBound(size) + blocks * 16 + 8;
+}
+
+size_t LzFrameCompress(const u8 *src, size_t srcSize, u8 *dst, size_t dstCapacity, u32 blockSize)
+{
+    size_t written = 0;
+    auto sink = [&](const u8 *data, size_t size)
+    {
+        if (size > dstCapacity - written)
+            return false;
+        memcpy(dst + written, data, size);
+        written += size;
+        return true;
+    };
+
+    LzStreamWriter writer;
+    bool ok = LzStreamBegin(&writer, sink, blockSize, srcSize) &&
+              LzStreamWrite(&writer, src, srcSize);
+    ok = LzStreamEnd(&writer) && ok;
+    return ok ? written : 0;
+}
+
+// Walks the blocks of a frame. `target(capacity)` returns where a compressed
+// block should be decoded; `emit(data, size)` receives every decoded block,
+// which for compressed blocks already lives at the target.
+template <typename Target, typename Emit>
+static bool DecodeFrame(const u8 *src, size_t srcSize, Target target, Emit emit)
+{
+    if (srcSize < sizeof(LzFrameHeader) + 8)
+        return false;
+
+    LzFrameHeader header;
+    memcpy(&header, src, sizeof(header));
+    if (header.magic != LZ_FRAME_MAGIC || header.blockSize == 0 || header.blockSize > MB(64))
+        return false;
+
+    const u8 *ip = src + sizeof(header);
+    const u8 *iend = src + srcSize;
+
+    Xxh32State hash;
+    Xxh32Begin(&hash);
+    u64 total = 0;
+
+    for (;;)
+    {
+        if (iend - ip < 4)
+            return false;
+        u32 blockHeader = Read32(ip);
+        ip += 4;
+        if (blockHeader == 0)
+            break;
+
+        u32 size = blockHeader & ~LZ_BLOCK_UNCOMPRESSED;
+        if (size > (size_t)(iend - ip))
+            return false;
+
+        const u8 *data = ip;
+        size_t decoded = size;
+        if (!(blockHeader & LZ_BLOCK_UNCOMPRESSED))
+        {
+            std::span<u8> out = target(header.blockSize);
+            i64 n = LzDecompress(ip, size, out.data(), out.size());
+            if (n < 0)
+                return false;
+            data = out.data();
+            decoded = (size_t)n;
+        }
+        else if (size > header.blockSize)
+        {
+            return false;
+        }
+
+        Xxh32Update(&hash, data, decoded);
+        total += decoded;
+        if (!emit(data, decoded))
+            return false;
+        ip += size;
+    }
+
+    if (iend - ip < 4 || Read32(ip) != Xxh32End(&hash))
+        return false;
+    return header.contentSize == 0 || header.contentSize == total;
+}
+
+bool LzFrameDecode(const u8 *src, size_t srcSize, const LzSink &sink)
+{
+    array<u8> block;
+    auto target = [&](u32 blockSize)
+    {
+        block.resize(blockSize);
+        return std::span<u8>(block);
+    };
+    return DecodeFrame(src, srcSize, target, sink);
+}
+
+i64 LzFrameDecompress(const u8 *src, size_t srcSize, u8 *dst, size_t dstCapacity)
+{
+    // Compressed blocks decode straight into dst; only raw blocks are copied
+    size_t written = 0;
+    auto target = [&](u32 blockSize)
+    {
+        return std::span<u8>(dst + written, std::min<size_t>(blockSize, dstCapacity - written));
+    };
+    auto emit = [&](const u8 *data, size_t size)
+    {
+        if (size > dstCapacity - written)
+            return false;
+        if (data != dst + written)
+            memcpy(dst + written, data, size);
+        written += size;
+        return true;
+    };
+
+    if (!DecodeFrame(src, srcSize, target, emit))
+        return -1;
+    return (i64)written;
+}
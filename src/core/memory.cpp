@@ -0,0 +1,643 @@
+#include <engine/memory.h>
+
+FrameArena frameArena;
+
+// ---------------- Frame Arena ----------------
+void InitFrameArena(FrameArena *arena, size_t perFrameReserve)
+{
+    arena->buffers[0] = MakeAllocator(perFrameReserve);
+    arena->buffers[1] = MakeAllocator(perFrameReserve);
+    Assert(arena->buffers[0].memory && arena->buffers[1].memory, "Not enough memory for the frame arena");
+    arena->current = 0;
+    arena->frame = 0;
+}
+
+void BeginFrameArena(FrameArena *arena)
+{
+    arena->current ^= 1;
+    arena->frame++;
+    ResetAllocator(&arena->buffers[arena->current]);
+}
+
+void TrimFrameArena(FrameArena *arena, size_t keepCommitted)
+{
+    // The current buffer was just reset; the other one still holds last frame's data
+    Assert(arena->buffers[arena->current].used == 0, "TrimFrameArena called mid-frame");
+    ResetAllocator(&arena->buffers[arena->current], true, keepCommitted);
+}
+
+void DestroyFrameArena(FrameArena *arena)
+{
+    ReleaseAllocator(&arena->buffers[0]);
+    ReleaseAllocator(&arena->buffers[1]);
+}
+
+BumpAllocator *FrameAllocator()
+{
+    return &frameArena.buffers[frameArena.current];
+}
+
+void *FrameAlloc(size_t size, size_t align)
+{
+    void *memory = BumpAllocAligned(FrameAllocator(), size, align);
+    Assert(memory, "FrameAlloc out of memory (%zu bytes)", size);
+    return memory;
+}
+
+char *FrameFormat(str fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int length = vsnprintf(nullptr, 0, fmt, args);
+    va_end(args);
+
+    if (length < 0)
+        return nullptr;
+
+    char *buffer = (char *)FrameAlloc(length + 1, 1);
+    if (!buffer)
+        return nullptr;
+
+    va_start(args, fmt);
+    vsnprintf(buffer, length + 1, fmt, args);
+    va_end(args);
+    return buffer;
+}
+
+// ---------------- Scratch Arenas ----------------
+struct ScratchArenas
+{
+    BumpAllocator arenas[SCRATCH_ARENA_COUNT] = {};
+
+    ~ScratchArenas()
+    {
+        for (BumpAllocator &arena : arenas)
+            ReleaseAllocator(&arena);
+    }
+};
+
+static thread_local ScratchArenas scratch;
+
+BumpAllocator *GetScratchArena(BumpAllocator *const *conflicts, u32 conflictCount)
+{
+    for (BumpAllocator &arena : scratch.arenas)
+    {
+        bool conflicting = false;
+        for (u32 i = 0; i < conflictCount; i++)
+            conflicting |= conflicts[i] == &arena;
+        if (conflicting)
+            continue;
+
+        if (!arena.memory)
+            arena = MakeAllocator(SCRATCH_ARENA_RESERVE);
+        return &arena;
+    }
+
+    Assert(false, "Every scratch arena is in the conflict list");
+    return nullptr;
+}
+
+void ReleaseScratchArenas()
+{
+    for (BumpAllocator &arena : scratch.arenas)
+    {
+        Assert(arena.used == 0, "ReleaseScratchArenas with an open TempMemory scope");
+        ReleaseAllocator(&arena);
+    }
+}
+
+void TrimScratchArenas(size_t keepCommitted)
+{
+    for (BumpAllocator &arena : scratch.arenas)
+    {
+        Assert(arena.used == 0, "TrimScratchArenas with an open TempMemory scope");
+        if (arena.memory)
+            ResetAllocator(&arena, true, keepCommitted);
+    }
+}
+
+// ---------------- Pool Allocator ----------------
+struct PoolThreadCache
+{
+    u32 poolId;
+    u32 count;
+    void *head;
+};
+
+static std::atomic<u32> nextPoolId{1};
+
+// Pools that are initialized and not destroyed. DestroyPool bumps the epoch
+// so every thread drops its cache entries for dead pools on its next access.
+static std::mutex livePoolsLock;
+static PoolAllocator *livePools = nullptr;
+static std::atomic<u32> poolEpoch{0};
+
+// Caller holds livePoolsLock
+static PoolAllocator *FindLivePool(u32 id)
+{
+    for (PoolAllocator *pool = livePools; pool; pool = pool->nextLive)
+    {
+        if (pool->id == id)
+            return pool;
+    }
+    return nullptr;
+}
+
+static inline void *PopBlock(void **list)
+{
+    void *block = *list;
+    if (block)
+        *list = *(void **)block;
+    return block;
+}
+
+static inline void PushBlock(void **list, void *block)
+{
+    *(void **)block = *list;
+    *list = block;
+}
+
+struct PoolThreadCaches
+{
+    PoolThreadCache caches[POOL_THREAD_CACHES] = {};
+    u32 epoch = 0;
+
+    // Cached blocks go back to their pools' shared lists instead of being
+    // stranded with the thread
+    ~PoolThreadCaches()
+    {
+        std::lock_guard<std::mutex> guard(livePoolsLock);
+        for (PoolThreadCache &cache : caches)
+        {
+            PoolAllocator *pool = cache.poolId ? FindLivePool(cache.poolId) : nullptr;
+            if (!pool)
+                continue;
+
+            std::lock_guard<std::mutex> poolGuard(pool->lock);
+            while (void *block = PopBlock(&cache.head))
+                PushBlock(&pool->freeList, block);
+            cache = PoolThreadCache{};
+        }
+    }
+};
+
+static thread_local PoolThreadCaches threadCaches;
+
+// Frees the slots of pools destroyed since this thread last looked. Their
+// blocks went away with the arena, so the entries are just dropped.
+static void DropDeadCaches(u32 epoch)
+{
+    std::lock_guard<std::mutex> guard(livePoolsLock);
+    for (PoolThreadCache &cache : threadCaches.caches)
+    {
+        if (cache.poolId && !FindLivePool(cache.poolId))
+            cache = PoolThreadCache{};
+    }
+    threadCaches.epoch = epoch;
+}
+
+static PoolThreadCache *GetThreadCache(PoolAllocator *pool)
+{
+    u32 epoch = poolEpoch.load(std::memory_order_acquire);
+    if (epoch != threadCaches.epoch)
+        DropDeadCaches(epoch);
+
+    PoolThreadCache *empty = nullptr;
+    for (PoolThreadCache &cache : threadCaches.caches)
+    {
+        if (cache.poolId == pool->id)
+            return &cache;
+        if (!empty && !cache.poolId)
+            empty = &cache;
+    }
+    if (empty)
+        *empty = PoolThreadCache{pool->id, 0, nullptr};
+    return empty; // nullptr: too many pools on this thread, use the shared list
+}
+
+// Takes a block from the shared list or carves a new one. Caller holds the lock.
+static void *TakeSharedBlock(PoolAllocator *pool)
+{
+    void *block = PopBlock(&pool->freeList);
+    if (block)
+        return block;
+
+    block = BumpAllocAligned(&pool->arena, pool->blockSize, pool->blockAlign);
+    if (block)
+        pool->carvedBlocks++;
+    return block;
+}
+
+static void TrackPoolAlloc(PoolAllocator *pool)
+{
+    size_t live = pool->liveBlocks.fetch_add(1, std::memory_order_relaxed) + 1;
+    size_t peak = pool->peakBlocks.load(std::memory_order_relaxed);
+    while (live > peak && !pool->peakBlocks.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+}
+
+void InitPool(PoolAllocator *pool, size_t blockSize, size_t blockAlign, size_t maxBlocks)
+{
+    blockAlign = std::max(blockAlign, alignof(void *));
+    blockSize = std::max(blockSize, sizeof(void *)); // room for the free list link
+    blockSize = (blockSize + blockAlign - 1) & ~(blockAlign - 1);
+
+    pool->id = nextPoolId.fetch_add(1, std::memory_order_relaxed);
+    pool->blockSize = blockSize;
+    pool->blockAlign = blockAlign;
+    pool->maxBlocks = maxBlocks;
+    pool->arena = MakeAllocator(blockSize * maxBlocks);
+    pool->freeList = nullptr;
+    pool->carvedBlocks = 0;
+    pool->liveBlocks = 0;
+    pool->peakBlocks = 0;
+
+    std::lock_guard<std::mutex> guard(livePoolsLock);
+    pool->nextLive = livePools;
+    livePools = pool;
+}
+
+#define MAX_SIZED_POOLS 64
+
+// Fixed storage: registration must not allocate from the tracked heap
+static std::mutex sizedPoolsLock;
+static PoolAllocator *sizedPools[MAX_SIZED_POOLS];
+static u32 sizedPoolCount = 0;
+
+void RegisterSizedPool(PoolAllocator *pool)
+{
+    std::lock_guard<std::mutex> guard(sizedPoolsLock);
+    Assert(sizedPoolCount < MAX_SIZED_POOLS, "Too many sized pools");
+    if (sizedPoolCount < MAX_SIZED_POOLS)
+        sizedPools[sizedPoolCount++] = pool;
+}
+
+void DestroyPool(PoolAllocator *pool)
+{
+    // Blocks still sitting in threads' caches are dropped with the arena; the
+    // epoch makes each thread forget them
+    {
+        std::lock_guard<std::mutex> guard(livePoolsLock);
+        for (PoolAllocator **link = &livePools; *link; link = &(*link)->nextLive)
+        {
+            if (*link == pool)
+            {
+                *link = pool->nextLive;
+                break;
+            }
+        }
+        pool->nextLive = nullptr;
+    }
+    poolEpoch.fetch_add(1, std::memory_order_release);
+
+    ReleaseAllocator(&pool->arena);
+    pool->freeList = nullptr;
+    pool->id = 0;
+}
+
+void *PoolAlloc(PoolAllocator *pool)
+{
+    PoolThreadCache *cache = GetThreadCache(pool);
+    void *block = cache ? PopBlock(&cache->head) : nullptr;
+
+    if (block)
+    {
+        cache->count--;
+    }
+    else
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        block = TakeSharedBlock(pool);
+
+        // Refill the local cache so the next allocations skip the lock
+        for (int i = 1; cache && block && i < POOL_CACHE_BATCH; i++)
+        {
+            void *extra = TakeSharedBlock(pool);
+            if (!extra)
+                break;
+            PushBlock(&cache->head, extra);
+            cache->count++;
+        }
+    }
+
+    Assert(block, "Pool of %zu byte blocks is full", pool->blockSize);
+    if (block)
+        TrackPoolAlloc(pool);
+    return block;
+}
+
+void PoolFree(PoolAllocator *pool, void *block)
+{
+    if (!block)
+        return;
+
+    pool->liveBlocks.fetch_sub(1, std::memory_order_relaxed);
+
+    PoolThreadCache *cache = GetThreadCache(pool);
+    if (!cache)
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        PushBlock(&pool->freeList, block);
+        return;
+    }
+
+    PushBlock(&cache->head, block);
+    if (++cache->count < POOL_CACHE_BATCH * 2)
+        return;
+
+    // Cache overflowing: hand a batch back to the shared list
+    std::lock_guard<std::mutex> guard(pool->lock);
+    for (int i = 0; i < POOL_CACHE_BATCH; i++)
+    {
+        PushBlock(&pool->freeList, PopBlock(&cache->head));
+        cache->count--;
+    }
+}
+
+PoolStats GetPoolStats(PoolAllocator *pool)
+{
+    std::lock_guard<std::mutex> guard(pool->lock);
+
+    PoolStats stats{};
+    stats.blockSize = pool->blockSize;
+    stats.maxBlocks = pool->maxBlocks;
+    stats.carvedBlocks = pool->carvedBlocks;
+    stats.liveBlocks = pool->liveBlocks.load(std::memory_order_relaxed);
+    stats.peakBlocks = pool->peakBlocks.load(std::memory_order_relaxed);
+    stats.committedBytes = pool->arena.committed;
+    stats.utilization = stats.carvedBlocks ? (float)stats.liveBlocks / (float)stats.carvedBlocks : 0.0f;
+    return stats;
+}
+
+// ---------------- Allocation Tracking ----------------
+struct TagCounters
+{
+    std::atomic<i64> liveBytes{0};
+    std::atomic<i64> peakBytes{0};
+    std::atomic<u64> allocCount{0};
+    std::atomic<u64> freeCount{0};
+    std::atomic<u64> frameAllocs{0};
+    std::atomic<u64> frameBytes{0};
+    u64 lastFrameAllocs = 0;
+    u64 lastFrameBytes = 0;
+};
+
+static TagCounters tagCounters[MEM_TAG_COUNT];
+static thread_local MemoryTag currentTag = MEM_GENERAL;
+
+// Header in front of TrackedMalloc / global new blocks, keeps 16-byte alignment
+struct alignas(16) TrackedHeader
+{
+    u64 size;
+    u32 tag;
+    u32 magic;
+};
+
+#define TRACKED_MAGIC 0xA71A5u
+
+str MemoryTagName(MemoryTag tag)
+{
+    switch (tag)
+    {
+        case MEM_GENERAL: return "general";
+        case MEM_ARENA:   return "arena";
+        case MEM_ECS:     return "ecs";
+        case MEM_RENDER:  return "render";
+        case MEM_ASSETS:  return "assets";
+        case MEM_FONTS:   return "fonts";
+        case MEM_AUDIO:   return "audio";
+        case MEM_EXTERNAL: return "external";
+        default:          return "?";
+    }
+}
+
+void TrackAlloc(MemoryTag tag, size_t size)
+{
+    TagCounters &c = tagCounters[tag];
+    i64 live = c.liveBytes.fetch_add((i64)size, std::memory_order_relaxed) + (i64)size;
+    i64 peak = c.peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !c.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+    c.allocCount.fetch_add(1, std::memory_order_relaxed);
+    c.frameAllocs.fetch_add(1, std::memory_order_relaxed);
+    c.frameBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void TrackFree(MemoryTag tag, size_t size)
+{
+    TagCounters &c = tagCounters[tag];
+    c.liveBytes.fetch_sub((i64)size, std::memory_order_relaxed);
+    c.freeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TrackResize(MemoryTag tag, i64 delta)
+{
+    TagCounters &c = tagCounters[tag];
+    i64 live = c.liveBytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+    i64 peak = c.peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !c.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+    if (delta > 0)
+        c.frameBytes.fetch_add((u64)delta, std::memory_order_relaxed);
+}
+
+void *TrackedMalloc(MemoryTag tag, size_t size)
+{
+    TrackedHeader *header = (TrackedHeader *)malloc(sizeof(TrackedHeader) + size);
+    if (!header)
+        return nullptr;
+
+    header->size = size;
+    header->tag = tag;
+    header->magic = TRACKED_MAGIC;
+    TrackAlloc(tag, size);
+    return header + 1;
+}
+
+void *TrackedRealloc(MemoryTag tag, void *ptr, size_t size)
+{
+    if (!ptr)
+        return TrackedMalloc(tag, size);
+
+    TrackedHeader *header = (TrackedHeader *)ptr - 1;
+    Assert(header->magic == TRACKED_MAGIC, "TrackedRealloc on a foreign pointer");
+    MemoryTag oldTag = (MemoryTag)header->tag;
+    size_t oldSize = header->size;
+
+    TrackedHeader *grown = (TrackedHeader *)realloc(header, sizeof(TrackedHeader) + size);
+    if (!grown)
+        return nullptr;
+
+    TrackFree(oldTag, oldSize);
+    grown->size = size;
+    grown->tag = tag;
+    TrackAlloc(tag, size);
+    return grown + 1;
+}
+
+void TrackedFree(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    TrackedHeader *header = (TrackedHeader *)ptr - 1;
+    Assert(header->magic == TRACKED_MAGIC, "TrackedFree on a foreign pointer");
+    TrackFree((MemoryTag)header->tag, header->size);
+    header->magic = 0;
+    free(header);
+}
+
+MemoryStats GetMemoryStats()
+{
+    MemoryStats stats{};
+    for (int i = 0; i < MEM_TAG_COUNT; i++)
+    {
+        TagCounters &c = tagCounters[i];
+        MemoryTagStats &t = stats.tags[i];
+        t.liveBytes = c.liveBytes.load(std::memory_order_relaxed);
+        t.peakBytes = c.peakBytes.load(std::memory_order_relaxed);
+        t.allocCount = c.allocCount.load(std::memory_order_relaxed);
+        t.liveAllocs = t.allocCount - c.freeCount.load(std::memory_order_relaxed);
+        t.frameAllocs = c.lastFrameAllocs;
+        t.frameBytes = c.lastFrameBytes;
+
+        stats.totalLiveBytes += t.liveBytes;
+        stats.totalPeakBytes += t.peakBytes;
+        stats.frameAllocs += t.frameAllocs;
+    }
+    return stats;
+}
+
+void EndMemoryFrame()
+{
+    for (TagCounters &c : tagCounters)
+    {
+        c.lastFrameAllocs = c.frameAllocs.exchange(0, std::memory_order_relaxed);
+        c.lastFrameBytes = c.frameBytes.exchange(0, std::memory_order_relaxed);
+    }
+}
+
+i64 ReportMemoryLeaks()
+{
+    i64 leaked = 0;
+    for (int i = 0; i < MEM_TAG_COUNT; i++)
+    {
+        TagCounters &c = tagCounters[i];
+        i64 live = c.liveBytes.load(std::memory_order_relaxed);
+        u64 allocs = c.allocCount.load(std::memory_order_relaxed) - c.freeCount.load(std::memory_order_relaxed);
+        if (i == MEM_EXTERNAL)
+            continue;
+        if (i == MEM_ARENA)
+        {
+            std::lock_guard<std::mutex> guard(sizedPoolsLock);
+            for (u32 p = 0; p < sizedPoolCount; p++)
+            {
+                PoolAllocator *pool = sizedPools[p];
+                if (!pool->arena.committed)
+                    continue;
+                live -= (i64)pool->arena.committed;
+                allocs--;
+            }
+        }
+        if (!live && !allocs)
+            continue;
+
+        print("Memory leak [%s]: %lld bytes in %llu allocations (peak %lld bytes)",
+              MemoryTagName((MemoryTag)i), (long long)live, (unsigned long long)allocs,
+              (long long)c.peakBytes.load(std::memory_order_relaxed));
+        leaked += live;
+    }
+    return leaked;
+}
+
+MemoryTagScope::MemoryTagScope(MemoryTag tag)
+    : previous(currentTag)
+{
+    currentTag = tag;
+}
+
+MemoryTagScope::~MemoryTagScope()
+{
+    currentTag = previous;
+}
+
+#ifdef ATLAS_TRACK_GLOBAL_NEW
+#ifndef NDEBUG
+// Constructed before any other static, so destroyed after all of them: the
+// report sees static containers already freed
+struct ExitLeakReport
+{
+    ~ExitLeakReport() { ReportMemoryLeaks(); }
+};
+
+#ifdef _MSC_VER
+#pragma init_seg(lib)
+static ExitLeakReport exitLeakReport;
+#else
+__attribute__((init_priority(101))) static ExitLeakReport exitLeakReport;
+#endif
+#endif
+
+// Route every plain new/delete through the tracker, tagged by MemoryTagScope.
+// Aligned new/delete keep the default implementation.
+#ifdef __linux__
+extern "C" char __executable_start[];
+extern "C" char etext[];
+
+// Shared libraries (the GL driver's compiler in particular) bind to this
+// operator new too; their allocations are tagged external
+static MemoryTag GlobalNewTag(void *caller)
+{
+    bool engine = caller >= (void *)__executable_start && caller < (void *)etext;
+    return engine ? currentTag : MEM_EXTERNAL;
+}
+#define GLOBAL_NEW_CALLER __builtin_return_address(0)
+#else
+static MemoryTag GlobalNewTag(void *)
+{
+    return currentTag;
+}
+#define GLOBAL_NEW_CALLER nullptr
+#endif
+
+static void *GlobalNew(size_t size, void *caller)
+{
+    void *p = TrackedMalloc(GlobalNewTag(caller), size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new(size_t size)
+{
+    return GlobalNew(size, GLOBAL_NEW_CALLER);
+}
+
+void *operator new[](size_t size)
+{
+    return GlobalNew(size, GLOBAL_NEW_CALLER);
+}
+
+void operator delete(void *p) noexcept
+{
+    TrackedFree(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    TrackedFree(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    TrackedFree(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    TrackedFree(p);
+}
+#endif
@@ -0,0 +1,92 @@
+#include <engine/pacing.h>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+static double NowSeconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------------- Precise wait ----------------
+
+// Welford running mean / variance of observed sleep durations
+static void RecordSleep(FramePacer *pacer, double observed)
+{
+    pacer->sleepCount++;
+    double delta = observed - pacer->sleepMean;
+    pacer->sleepMean += delta / pacer->sleepCount;
+    pacer->sleepM2 += delta * (observed - pacer->sleepMean);
+    pacer->sleepEstimate = pacer->sleepMean + std::sqrt(pacer->sleepM2 / (pacer->sleepCount - 1));
+}
+
+static void WaitUntil(FramePacer *pacer, double deadline)
+{
+    // Sleep while even a pessimistic sleep ends before the deadline
+    for (double now = NowSeconds(); deadline - now > pacer->sleepEstimate;)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        double after = NowSeconds();
+        RecordSleep(pacer, after - now);
+        now = after;
+    }
+
+    // Spin the rest, yielding so a core is shared rather than burned
+    while (NowSeconds() < deadline)
+        std::this_thread::yield();
+}
+
+// ---------------- Frame pacer ----------------
+
+void InitFramePacer(FramePacer *pacer, u32 targetFps, bool idleMode)
+{
+    *pacer = {};
+    SetTargetFps(pacer, targetFps);
+    pacer->idleMode = idleMode && !IsHeadless();
+    pacer->deadline = NowSeconds();
+}
+
+void SetTargetFps(FramePacer *pacer, u32 targetFps)
+{
+    pacer->targetFrameTime = targetFps && !IsHeadless() ? 1.0 / targetFps : 0.0;
+}
+
+void RequestRedraw(FramePacer *pacer)
+{
+    pacer->redraw = true;
+}
+
+bool ShouldRender(FramePacer *pacer, const Event &event)
+{
+    if (!pacer->idleMode || pacer->redraw || event.activity)
+    {
+        pacer->redraw = false;
+        return true;
+    }
+    pacer->skippedFrames++;
+    return false;
+}
+
+void WaitForNextFrame(FramePacer *pacer, bool rendered)
+{
+    if (!rendered)
+    {
+        // Nothing on screen changes until an event or an asset update
+        WaitForEvents(FRAME_PACER_IDLE_MS / 1000.0);
+        pacer->deadline = NowSeconds();
+        return;
+    }
+    if (pacer->targetFrameTime <= 0.0)
+        return;
+
+    double now = NowSeconds();
+    pacer->deadline += pacer->targetFrameTime;
+    if (pacer->deadline < now - pacer->targetFrameTime)
+    {
+        // More than a frame behind (a hitch, a breakpoint): start over from
+        // now rather than rushing frames out to catch up
+        pacer->deadline = now;
+        return;
+    }
+    WaitUntil(pacer, pacer->deadline);
+}
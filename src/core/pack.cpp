@@ -0,0 +1,147 @@
+#include <engine/pack.h>
+#include <engine/lz.h>
+#include <string.h>
+
+// [offset, offset + length) lies inside a file of `size` bytes, without overflow
+static bool RangeFits(u64 offset, u64 length, u64 size)
+{
+    return offset <= size && length <= size - offset;
+}
+
+// Every lookup and read trusts the table of contents, so it's checked once here
+static bool ValidatePackEntries(const PackFile *pack)
+{
+    u64 size = pack->file.size;
+    u64 stringsSize = pack->header->stringsSize;
+    for (u32 i = 0; i < pack->header->entryCount; i++)
+    {
+        const PackEntry &entry = pack->entries[i];
+        if (!RangeFits(entry.offset, entry.size, size) || entry.pathOffset >= stringsSize)
+            return false;
+
+        // The path has to end inside the string table
+        const char *path = pack->strings + entry.pathOffset;
+        if (!memchr(path, '\0', (size_t)(stringsSize - entry.pathOffset)))
+            return false;
+
+        switch (entry.compression)
+        {
+            case PACK_COMPRESSION_NONE:
+                if (entry.rawSize != entry.size)
+                    return false;
+                break;
+            case PACK_COMPRESSION_LZ:
+                break;
+            default:
+                return false;
+        }
+
+        if (i && pack->entries[i - 1].pathHash > entry.pathHash)
+            return false;
+    }
+    return true;
+}
+
+bool OpenPack(PackFile *pack, str path)
+{
+    pack->file = MapFile(path, MAP_HINT_RANDOM);
+    if (!pack->file.valid || pack->file.size < sizeof(PackHeader))
+    {
+        ClosePack(pack);
+        return false;
+    }
+
+    const u8 *base = pack->file.data;
+    u64 size = pack->file.size;
+    const PackHeader *header = (const PackHeader *)base;
+
+    bool valid = header->magic == PACK_MAGIC &&
+                 header->version == PACK_VERSION &&
+                 header->tocOffset % alignof(PackEntry) == 0 &&
+                 RangeFits(header->tocOffset, 0, size) &&
+                 header->entryCount <= (size - header->tocOffset) / sizeof(PackEntry) &&
+                 RangeFits(header->stringsOffset, header->stringsSize, size);
+    if (valid)
+    {
+        pack->header = header;
+        pack->entries = (const PackEntry *)(base + header->tocOffset);
+        pack->strings = (const char *)(base + header->stringsOffset);
+        valid = ValidatePackEntries(pack);
+    }
+    if (!valid)
+    {
+        print("Invalid pack file: %s", path);
+        ClosePack(pack);
+        return false;
+    }
+    return true;
+}
+
+void ClosePack(PackFile *pack)
+{
+    UnmapFile(&pack->file);
+    pack->header = nullptr;
+    pack->entries = nullptr;
+    pack->strings = nullptr;
+}
+
+const PackEntry *FindPackEntry(const PackFile *pack, u64 pathHash, str path)
+{
+    if (!pack->header)
+        return nullptr;
+
+    u32 lo = 0;
+    u32 hi = pack->header->entryCount;
+    while (lo < hi)
+    {
+        u32 mid = lo + (hi - lo) / 2;
+        if (pack->entries[mid].pathHash < pathHash)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    for (u32 i = lo; i < pack->header->entryCount && pack->entries[i].pathHash == pathHash; i++)
+    {
+        if (!path || strcmp(GetPackEntryPath(pack, &pack->entries[i]), path) == 0)
+            return &pack->entries[i];
+    }
+    return nullptr;
+}
+
+const PackEntry *FindPackEntry(const PackFile *pack, str path)
+{
+    return FindPackEntry(pack, HashString(path), path);
+}
+
+str GetPackEntryPath(const PackFile *pack, const PackEntry *entry)
+{
+    return pack->strings + entry->pathOffset;
+}
+
+std::span<const u8> GetPackEntryData(const PackFile *pack, const PackEntry *entry)
+{
+    return {pack->file.data + entry->offset, (size_t)entry->size};
+}
+
+bool ReadPackEntry(const PackFile *pack, const PackEntry *entry, u8 *dst)
+{
+    std::span<const u8> data = GetPackEntryData(pack, entry);
+
+    switch (entry->compression)
+    {
+        case PACK_COMPRESSION_NONE:
+            memcpy(dst, data.data(), data.size());
+            return true;
+        case PACK_COMPRESSION_LZ:
+            if (LzFrameDecompress(data.data(), data.size(), dst, entry->rawSize) != (i64)entry->rawSize)
+            {
+                print("Corrupt compressed pack entry: %s", GetPackEntryPath(pack, entry));
+                return false;
+            }
+            return true;
+        default:
+            print("Unknown pack compression %u for %s", entry->compression, GetPackEntryPath(pack, entry));
+            return false;
+    }
+}
@@ -0,0 +1,50 @@
+#include <platform/platform.h>
+#include <engine/memory.h>
+#include <engine/io.h>
+#include <engine/vfs.h>
+#include <string.h>
+
+BumpAllocator persistentStorage;
+Input input = nullptr;
+
+// ---------------- Engine services ----------------
+void InitEngineServices()
+{
+    // Address space only, pages are committed on first use
+    persistentStorage = MakeAllocator(GB(4));
+    input = BumpAlloc<Input_>(&persistentStorage);
+    InitFrameArena(&frameArena, MB(256));
+    InitIoService();
+
+    // Loose files relative to the working directory; packs mount above it
+    VfsMountDirectory(".");
+}
+
+void ShutdownEngineServices()
+{
+    ShutdownIoService();
+    ShutdownVfs();
+    DestroyFrameArena(&frameArena);
+    ReleaseAllocator(&persistentStorage);
+    ReleaseScratchArenas();
+    input = nullptr;
+
+    // With global new tracked, memory.cpp reports at exit instead
+#if !defined(NDEBUG) && !defined(ATLAS_TRACK_GLOBAL_NEW)
+    ReportMemoryLeaks();
+#endif
+}
+
+// ---------------- Extension strings ----------------
+bool HasExtension(str extensions, str name)
+{
+    size_t length = strlen(name);
+    for (str at = extensions; at && (at = strstr(at, name)); at += length)
+    {
+        bool start = at == extensions || at[-1] == ' ';
+        bool end = at[length] == ' ' || at[length] == '\0';
+        if (start && end)
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,119 @@
+#include <engine/render.h>
+#include <algorithm>
+
+array<Batch> batches;
+
+void DrawQuad(Batch &b, vec2 pos, vec2 size, ivec2 ioffset, ivec2 isize, vec4 color, bool flipX, bool flipY)
+{
+    u32 startIndex = b.vertices.size();
+
+    // 1. Calculate atlas pixel coordinates
+    float x0 = float(ioffset.x);
+    float y0 = float(ioffset.y);
+    float x1 = float(ioffset.x + isize.x);
+    float y1 = float(ioffset.y + isize.y);
+
+    // Handle flipping (useful for sprites, usually false for text)
+    if (flipX)
+        std::swap(x0, x1);
+    if (flipY)
+        std::swap(y0, y1);
+
+    // Normalize UVs (0 to 1 range)
+    float w = float(b.w);
+    float h = float(b.h);
+
+    vec2 uvTL = vec2(x0 / w, y0 / h);
+    vec2 uvTR = vec2(x1 / w, y0 / h);
+    vec2 uvBR = vec2(x1 / w, y1 / h);
+    vec2 uvBL = vec2(x0 / w, y1 / h);
+
+    // 2. Push vertices (Counter-Clockwise order)
+    // Using your Ortho: (0,0) is bottom-left, (screen.x, screen.y) is top-right
+    b.vertices.push_back(Vertex{.pos = vec2(pos.x, pos.y), .uv = uvBL, .color = color});                   // Bottom-Left
+    b.vertices.push_back(Vertex{.pos = vec2(pos.x + size.x, pos.y), .uv = uvBR, .color = color});          // Bottom-Right
+    b.vertices.push_back(Vertex{.pos = vec2(pos.x + size.x, pos.y + size.y), .uv = uvTR, .color = color}); // Top-Right
+    b.vertices.push_back(Vertex{.pos = vec2(pos.x, pos.y + size.y), .uv = uvTL, .color = color});          // Top-Left
+
+    // 3. Push indices
+    b.indices.push_back(startIndex + 0);
+    b.indices.push_back(startIndex + 1);
+    b.indices.push_back(startIndex + 2);
+    b.indices.push_back(startIndex + 2);
+    b.indices.push_back(startIndex + 3);
+    b.indices.push_back(startIndex + 0);
+};
+
+void DrawRect(vec2 pos, vec2 size, ivec2 ioffset, ivec2 isize, vec4 color, bool flipX, bool flipY)
+{
+    DrawQuad(
+        batches[0], pos,
+        size, ioffset,
+        isize, color,
+        flipX, flipY);
+}
+
+// ---------------- Circle tessellation cache ----------------
+// Unit circle points and fan indices per segment count, built on first use so
+// DrawCircle is a scale + offset copy with no trig or modulo per vertex.
+struct CircleFan
+{
+    array<vec2> points;  // segment points on the unit circle
+    array<u32> indices;  // relative to the center vertex (0)
+};
+
+static CircleFan circleFans[CIRCLE_MAX_SEGMENTS + 1];
+
+static const CircleFan &GetCircleFan(int segment)
+{
+    CircleFan &fan = circleFans[segment];
+    if (!fan.points.empty())
+        return fan;
+
+    fan.points.resize(segment);
+    for (int i = 0; i < segment; i++)
+    {
+        float theta = 2.0f * 3.1415926f * float(i) / float(segment);
+        fan.points[i] = vec2(cosf(theta), sinf(theta));
+    }
+
+    fan.indices.resize(segment * 3);
+    for (int i = 0; i < segment; i++)
+    {
+        fan.indices[i * 3 + 0] = 0; // center
+        fan.indices[i * 3 + 1] = 1 + i;
+        fan.indices[i * 3 + 2] = (i + 1 < segment) ? 2 + i : 1;
+    }
+    return fan;
+}
+
+void DrawCircle(vec2 pos, float radius, int segment, vec4 color)
+{
+    segment = std::clamp(segment, 3, CIRCLE_MAX_SEGMENTS);
+    const CircleFan &fan = GetCircleFan(segment);
+
+    auto& vertices = batches[0].vertices;
+    auto& indices = batches[0].indices;
+    u32 startIndex = vertices.size();
+    size_t startElement = indices.size();
+
+    vertices.resize(startIndex + 1 + segment);
+    indices.resize(startElement + segment * 3);
+
+    Vertex *v = vertices.data() + startIndex;
+    v[0] = Vertex{.pos = pos, .uv = vec2(0.0f), .color = color}; // center
+
+    const vec2 *unit = fan.points.data();
+    for (int i = 0; i < segment; i++)
+    {
+        v[1 + i] = Vertex{
+            .pos = vec2(pos.x + unit[i].x * radius, pos.y + unit[i].y * radius),
+            .uv = vec2(0.0f),
+            .color = color};
+    }
+
+    u32 *idx = indices.data() + startElement;
+    const u32 *rel = fan.indices.data();
+    for (int i = 0; i < segment * 3; i++)
+        idx[i] = startIndex + rel[i];
+}
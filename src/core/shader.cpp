@@ -1,91 +1,627 @@
 #include <engine/shader.h>
+#include <engine/uniforms.h>
+#include <platform/platform.h>
 #include <glad/glad.h>
+#include <string.h>
+#include <algorithm>
+#include <filesystem>
 
-u32 CompileShader(const char *source, i32 type)
+// KHR_parallel_shader_compile (and its ARB twin) isn't in the generated loader.
+// Only the thread count is set; programs are still finished in submission
+// order with the blocking GL_LINK_STATUS query, since nothing is returned
+// before all of them are done anyway.
+typedef void(APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+#define SHADER_CACHE_MAGIC 0x4E424853u // "SHBN"
+#define SHADER_CACHE_VERSION 1
+#define SHADER_MAX_INCLUDE_DEPTH 16
+
+struct ShaderCacheHeader
 {
-    u32 shader = glCreateShader(type);
-    glShaderSource(shader, 1, &source, nullptr);
-    glCompileShader(shader);
+    u32 magic;
+    u32 version;
+    u64 key;
+    u32 format; // from glGetProgramBinary
+    u32 size;   // of the binary following the header
+};
+
+// Queried once, on the first program built
+struct ShaderDriver
+{
+    bool initialized;
+    bool binaryCache;     // driver supports at least one binary format
+    bool parallelCompile; // KHR / ARB_parallel_shader_compile
+    u64 hash;             // vendor, renderer and version
+};
+
+// A program between submission and its first status query
+struct PendingProgram
+{
+    std::string vertSource; // preprocessed
+    std::string fragSource;
+    array<std::string> vertFiles; // source string numbers in compile logs
+    array<std::string> fragFiles;
+    u64 key;
+    u32 id;
+    u32 vertexShader;
+    u32 fragmentShader;
+    bool fromCache;
+};
+
+static ShaderDriver driver;
+
+// #define names of the ShaderFeature bits, in bit order
+static const char *featureDefines[SHADER_FEATURE_COUNT] = {"TEXT", "ALPHA_TEST", "SDF"};
+
+// ---------------- Preprocessor ----------------
+
+// "dir/a.frag" + "../common/b.glsl" -> "common/b.glsl"
+static std::string ResolveInclude(const std::string &from, std::string_view name)
+{
+    std::filesystem::path dir = std::filesystem::path(from).parent_path();
+    return (dir / std::filesystem::path(name)).lexically_normal().generic_string();
+}
+
+// Appends `path` to `out` with its #include lines expanded in place. Files
+// are numbered by their index in `files`, which #line directives use as the
+// source string number.
+static bool ExpandShaderFile(const std::string &path, std::string *out, array<std::string> *files, u32 depth)
+{
+    if (depth > SHADER_MAX_INCLUDE_DEPTH)
+    {
+        print("Shader includes nested too deep: %s", path.c_str());
+        return false;
+    }
+    if (std::find(files->begin(), files->end(), path) != files->end())
+        return true; // every file is included once
+
+    VfsFile file = VfsOpen(VfsPath(path.c_str()));
+    if (!file.valid)
+    {
+        print("Failed to read shader file: %s", path.c_str());
+        return false;
+    }
+
+    u32 index = (u32)files->size();
+    files->push_back(path);
+    if (depth > 0)
+        out->append("#line 1 ").append(std::to_string(index)).push_back('\n');
+
+    std::string_view text = file.Text();
+    u32 lineNumber = 0;
+    for (size_t at = 0; at < text.size();)
+    {
+        size_t end = std::min(text.find('\n', at), text.size());
+        std::string_view line = text.substr(at, end - at);
+        at = end + 1;
+        lineNumber++;
+
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string_view::npos || line.compare(first, 8, "#include") != 0)
+        {
+            out->append(line).push_back('\n');
+            continue;
+        }
+
+        size_t open = line.find('"', first);
+        size_t close = open == std::string_view::npos ? open : line.find('"', open + 1);
+        if (close == std::string_view::npos)
+        {
+            print("%s:%u: expected #include \"file\"", path.c_str(), lineNumber);
+            return false;
+        }
+
+        std::string included = ResolveInclude(path, line.substr(open + 1, close - open - 1));
+        if (!ExpandShaderFile(included, out, files, depth + 1))
+            return false;
+        out->append("#line ").append(std::to_string(lineNumber + 1)).append(" ").append(std::to_string(index)).push_back('\n');
+    }
+    return true;
+}
 
+bool PreprocessShader(VfsPath path, std::span<const std::string> defines, std::string *out, array<std::string> *files)
+{
+    out->clear();
+    files->clear();
+    if (!ExpandShaderFile(path.path, out, files, 0))
+        return false;
+
+    // Defines go right after #version, which has to stay the first statement
+    std::string injected;
+    for (const std::string &define : defines)
+        injected.append("#define ").append(define).push_back('\n');
+    if (injected.empty())
+        return true;
+
+    size_t version = out->find("#version");
+    size_t insertAt = version == std::string::npos ? 0 : std::min(out->find('\n', version), out->size() - 1) + 1;
+    u32 nextLine = 1 + (u32)std::count(out->begin(), out->begin() + insertAt, '\n');
+    injected.append("#line ").append(std::to_string(nextLine)).append(" 0\n");
+    out->insert(insertAt, injected);
+    return true;
+}
+
+array<std::string> ShaderFeatureDefines(u32 features)
+{
+    array<std::string> defines;
+    for (u32 bit = 0; bit < SHADER_FEATURE_COUNT; bit++)
+    {
+        if (features & (1u << bit))
+            defines.push_back(featureDefines[bit]);
+    }
+    return defines;
+}
+
+// ---------------- Compilation ----------------
+
+static void PrintShaderLog(u32 shader, str stage, const array<std::string> &files = {})
+{
     i32 success;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
     if (!success)
     {
         char log[1024];
         glGetShaderInfoLog(shader, 1024, nullptr, log);
-        print("Failed to Compile Shader(%s): %s",
-              type == GL_VERTEX_SHADER ? "Vertex" : "Fragment",
-              log);
+        print("Failed to Compile Shader(%s): %s", stage, log);
+
+        // Log lines read "<source number>:<line>"
+        for (size_t i = 0; i < files.size(); i++)
+            print("  source %zu: %s", i, files[i].c_str());
     }
+}
+
+u32 CompileShader(const char *source, i32 type, i32 length)
+{
+    u32 shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, length < 0 ? nullptr : &length);
+    glCompileShader(shader);
+    PrintShaderLog(shader, type == GL_VERTEX_SHADER ? "Vertex" : "Fragment");
     return shader;
 }
 
-u32 CreateShaderProgram(str vertPath, str fragPath)
+// Continues FNV-1a over `data`; the length goes in too, so "ab" + "c" and
+// "a" + "bc" hash differently
+static u64 HashAppend(u64 hash, std::string_view data)
+{
+    for (char c : data)
+    {
+        hash ^= (u8)c;
+        hash *= 0x100000001b3ull;
+    }
+    for (u32 i = 0; i < 8; i++)
+    {
+        hash ^= (u8)(data.size() >> (i * 8));
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static void InitShaderDriver()
 {
-    char *vertSource = read_file(vertPath);
-    char *fragSource = read_file(fragPath);
+    if (driver.initialized)
+        return;
+    driver.initialized = true;
+
+    i32 formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    driver.binaryCache = formatCount > 0;
 
-    if (!vertSource || !fragSource)
+    // Binaries only load on the driver build that produced them
+    driver.hash = HashString("");
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
     {
-        print("Failed to read shader files!");
-        if (vertSource)
-            free(vertSource);
-        if (fragSource)
-            free(fragSource);
-        return 0;
+        const char *value = (const char *)glGetString(name);
+        driver.hash = HashAppend(driver.hash, value ? value : "");
     }
 
-    u32 vertexShader = CompileShader(vertSource, GL_VERTEX_SHADER);
-    u32 fragmentShader = CompileShader(fragSource, GL_FRAGMENT_SHADER);
+    i32 extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (i32 i = 0; i < extensionCount; i++)
+    {
+        const char *extension = (const char *)glGetStringi(GL_EXTENSIONS, i);
+        driver.parallelCompile |= strcmp(extension, "GL_KHR_parallel_shader_compile") == 0 ||
+                                  strcmp(extension, "GL_ARB_parallel_shader_compile") == 0;
+    }
 
-    free(vertSource);
-    free(fragSource);
+    if (driver.parallelCompile)
+    {
+        auto maxThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)GetGLProcAddress("glMaxShaderCompilerThreadsKHR");
+        if (!maxThreads)
+            maxThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)GetGLProcAddress("glMaxShaderCompilerThreadsARB");
+        if (maxThreads)
+            maxThreads(0xFFFFFFFFu); // as many threads as the driver likes
+    }
+}
 
-    u32 program = glCreateProgram();
-    glAttachShader(program, vertexShader);
-    glAttachShader(program, fragmentShader);
-    glLinkProgram(program);
+// ---------------- Binary cache ----------------
 
-    i32 success;
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success)
+static std::string ShaderCachePath(u64 key)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.bin", (unsigned long long)key);
+    return std::string(SHADER_CACHE_DIR) + name;
+}
+
+static bool LoadCachedBinary(PendingProgram *pending)
+{
+    MappedFile file = MapFile(ShaderCachePath(pending->key).c_str());
+    if (!file.valid || file.size < sizeof(ShaderCacheHeader))
+        return false;
+
+    const ShaderCacheHeader *header = (const ShaderCacheHeader *)file.data;
+    if (header->magic != SHADER_CACHE_MAGIC || header->version != SHADER_CACHE_VERSION ||
+        header->key != pending->key || header->size != file.size - sizeof(ShaderCacheHeader))
+        return false;
+
+    // Like a link, this may finish asynchronously; the status is checked later
+    pending->id = glCreateProgram();
+    glProgramBinary(pending->id, header->format, file.data + sizeof(ShaderCacheHeader), (i32)header->size);
+    pending->fromCache = true;
+    return true;
+}
+
+static void SaveCachedBinary(const PendingProgram *pending)
+{
+    i32 length = 0;
+    glGetProgramiv(pending->id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    array<u8> data(sizeof(ShaderCacheHeader) + length);
+    ShaderCacheHeader header = {SHADER_CACHE_MAGIC, SHADER_CACHE_VERSION, pending->key, 0, (u32)length};
+    glGetProgramBinary(pending->id, length, nullptr, &header.format, data.data() + sizeof(header));
+    memcpy(data.data(), &header, sizeof(header));
+
+    // Written aside and renamed, so another instance never maps half a file
+    std::error_code error;
+    std::filesystem::create_directories(SHADER_CACHE_DIR, error);
+    std::string path = ShaderCachePath(pending->key);
+    std::string temp = path + ".tmp";
+    if (!write_file(temp.c_str(), (const char *)data.data(), data.size()))
+        return;
+    std::filesystem::rename(temp, path, error);
+    if (error)
+        std::filesystem::remove(temp, error);
+}
+
+// ---------------- Programs ----------------
+
+// Starts compiling and linking without asking for the result: with parallel
+// shader compile the driver works on it in the background until then
+static void SubmitCompile(PendingProgram *pending)
+{
+    const char *vert = pending->vertSource.data();
+    const char *frag = pending->fragSource.data();
+    i32 vertLength = (i32)pending->vertSource.size();
+    i32 fragLength = (i32)pending->fragSource.size();
+
+    pending->vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(pending->vertexShader, 1, &vert, &vertLength);
+    glCompileShader(pending->vertexShader);
+
+    pending->fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(pending->fragmentShader, 1, &frag, &fragLength);
+    glCompileShader(pending->fragmentShader);
+
+    pending->id = glCreateProgram();
+    glProgramParameteri(pending->id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glAttachShader(pending->id, pending->vertexShader);
+    glAttachShader(pending->id, pending->fragmentShader);
+    glLinkProgram(pending->id);
+    pending->fromCache = false;
+}
+
+static bool SubmitProgram(PendingProgram *pending, VfsPath vertPath, VfsPath fragPath, u32 features)
+{
+    array<std::string> defines = ShaderFeatureDefines(features);
+    if (!PreprocessShader(vertPath, defines, &pending->vertSource, &pending->vertFiles) ||
+        !PreprocessShader(fragPath, defines, &pending->fragSource, &pending->fragFiles))
+        return false;
+
+    // Keyed by the expanded text, so editing an include or changing the
+    // defines is a different program
+    pending->key = HashAppend(HashAppend(driver.hash, pending->vertSource), pending->fragSource);
+    if (!driver.binaryCache || !LoadCachedBinary(pending))
+        SubmitCompile(pending);
+    return true;
+}
+
+// Waits for the program; returns it, or 0 after printing the logs
+static u32 FinishProgram(PendingProgram *pending)
+{
+    i32 linked = 0;
+    if (pending->fromCache)
+    {
+        glGetProgramiv(pending->id, GL_LINK_STATUS, &linked);
+        if (linked)
+            return pending->id;
+
+        // The driver rejected the binary after all; build from source
+        glDeleteProgram(pending->id);
+        SubmitCompile(pending);
+    }
+
+    glGetProgramiv(pending->id, GL_LINK_STATUS, &linked);
+    if (!linked)
     {
+        PrintShaderLog(pending->vertexShader, "Vertex", pending->vertFiles);
+        PrintShaderLog(pending->fragmentShader, "Fragment", pending->fragFiles);
+
         char log[1024];
-        glGetProgramInfoLog(program, 1024, nullptr, log);
+        glGetProgramInfoLog(pending->id, 1024, nullptr, log);
         print("Failed to Link Program Shader: %s", log);
+    }
+
+    glDeleteShader(pending->vertexShader);
+    glDeleteShader(pending->fragmentShader);
+
+    if (!linked)
+    {
+        glDeleteProgram(pending->id);
         return 0;
     }
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    if (driver.binaryCache)
+        SaveCachedBinary(pending);
+    return pending->id;
+}
+
+u32 CreateShaderProgram(VfsPath vertPath, VfsPath fragPath)
+{
+    InitShaderDriver();
+
+    PendingProgram pending = {};
+    return SubmitProgram(&pending, vertPath, fragPath, 0) ? FinishProgram(&pending) : 0;
+}
+
+// ---------------- Reflection ----------------
+
+// "lights[0]" -> "lights", so arrays are set by their plain name
+static std::string_view UniformBaseName(const char *name, i32 length)
+{
+    std::string_view view(name, length);
+    if (view.ends_with("[0]"))
+        view.remove_suffix(3);
+    return view;
+}
+
+static void ReflectProgram(ShaderProgram *program)
+{
+    char name[256];
+
+    i32 uniformCount = 0;
+    glGetProgramiv(program->id, GL_ACTIVE_UNIFORMS, &uniformCount);
+    for (i32 i = 0; i < uniformCount; i++)
+    {
+        i32 length = 0, count = 0;
+        u32 type = 0;
+        glGetActiveUniform(program->id, i, sizeof(name), &length, &count, &type, name);
+
+        // Members of uniform blocks have no location of their own
+        i32 location = glGetUniformLocation(program->id, name);
+        if (location < 0)
+            continue;
+
+        ShaderUniform uniform = {};
+        uniform.location = location;
+        uniform.type = type;
+        uniform.count = count;
+
+        u64 hash = HashString(UniformBaseName(name, length));
+        bool added = program->uniforms.emplace(hash, uniform).second;
+        Assert(added, "Uniform name hash collision: %s", name);
+    }
+
+    i32 attributeCount = 0;
+    glGetProgramiv(program->id, GL_ACTIVE_ATTRIBUTES, &attributeCount);
+    for (i32 i = 0; i < attributeCount; i++)
+    {
+        i32 length = 0, count = 0;
+        u32 type = 0;
+        glGetActiveAttrib(program->id, i, sizeof(name), &length, &count, &type, name);
+
+        ShaderAttribute attribute = {glGetAttribLocation(program->id, name), type};
+        bool added = program->attributes.emplace(HashString(std::string_view(name, length)), attribute).second;
+        Assert(added, "Attribute name hash collision: %s", name);
+    }
 
-    return program;
+    // GLSL 330 can't declare block bindings, so blocks are bound by name
+    i32 blockCount = 0;
+    glGetProgramiv(program->id, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+    for (i32 i = 0; i < blockCount; i++)
+    {
+        i32 length = 0;
+        glGetActiveUniformBlockName(program->id, i, sizeof(name), &length, name);
+        i32 binding = UniformBlockBinding(std::string_view(name, length));
+        if (binding < 0)
+        {
+            print("Unknown uniform block: %s", name);
+            continue;
+        }
+        glUniformBlockBinding(program->id, i, binding);
+    }
+}
+
+bool LoadShaderPrograms(std::span<const ShaderSource> sources, array<std::string> *files)
+{
+    InitShaderDriver();
+
+    // Everything is submitted before the first status query, which is what
+    // lets a parallel-compiling driver build all programs at once
+    array<PendingProgram> pending(sources.size());
+    array<bool> submitted(sources.size());
+    for (size_t i = 0; i < sources.size(); i++)
+        submitted[i] = SubmitProgram(&pending[i], sources[i].vertPath, sources[i].fragPath, sources[i].features);
+
+    if (files)
+    {
+        for (const PendingProgram &program : pending)
+        {
+            for (const array<std::string> *list : {&program.vertFiles, &program.fragFiles})
+            {
+                for (const std::string &file : *list)
+                {
+                    if (std::find(files->begin(), files->end(), file) == files->end())
+                        files->push_back(file);
+                }
+            }
+        }
+    }
+
+    bool success = true;
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        ShaderProgram loaded;
+        loaded.id = submitted[i] ? FinishProgram(&pending[i]) : 0;
+        if (!loaded.id)
+        {
+            success = false;
+            continue;
+        }
+
+        ReflectProgram(&loaded);
+        DestroyShaderProgram(sources[i].program);
+        *sources[i].program = std::move(loaded);
+    }
+    return success;
+}
+
+bool LoadShaderProgram(ShaderProgram *program, VfsPath vertPath, VfsPath fragPath)
+{
+    ShaderSource source = {program, vertPath, fragPath};
+    return LoadShaderPrograms({&source, 1});
+}
+
+bool LoadShaderVariants(ShaderVariants *variants, VfsPath vertPath, VfsPath fragPath, std::span<const u32> keys)
+{
+    variants->vertPath = vertPath.path;
+    variants->fragPath = fragPath.path;
+    variants->keys.assign(keys.begin(), keys.end());
+    return ReloadShaderVariants(variants);
+}
+
+bool ReloadShaderVariants(ShaderVariants *variants)
+{
+    VfsPath vertPath(variants->vertPath.c_str());
+    VfsPath fragPath(variants->fragPath.c_str());
+
+    array<ShaderSource> sources;
+    for (u32 key : variants->keys)
+    {
+        Assert(key < SHADER_VARIANT_COUNT, "Unknown shader feature bits: %x", key);
+        sources.push_back(ShaderSource{&variants->programs[key], vertPath, fragPath, key});
+    }
+
+    variants->files.clear();
+    return LoadShaderPrograms(sources, &variants->files);
+}
+
+ShaderProgram *GetShaderVariant(ShaderVariants *variants, u32 key)
+{
+    return &variants->programs[key & (SHADER_VARIANT_COUNT - 1)];
+}
+
+void DestroyShaderVariants(ShaderVariants *variants)
+{
+    for (ShaderProgram &program : variants->programs)
+        DestroyShaderProgram(&program);
+}
+
+void DestroyShaderProgram(ShaderProgram *program)
+{
+    if (program->id)
+        glDeleteProgram(program->id);
+    program->id = 0;
+    program->uniforms.clear();
+    program->attributes.clear();
+}
+
+const ShaderUniform *FindUniform(const ShaderProgram &program, ShaderName name)
+{
+    auto it = program.uniforms.find(name.hash);
+    return it != program.uniforms.end() ? &it->second : nullptr;
+}
+
+i32 GetAttributeLocation(const ShaderProgram &program, ShaderName name)
+{
+    auto it = program.attributes.find(name.hash);
+    return it != program.attributes.end() ? it->second.location : -1;
+}
+
+// ---------------- Uniforms ----------------
+
+// Uploads `value` unless it's bytewise equal to the last upload
+template <typename T, typename Upload>
+static void UploadUniform(ShaderProgram *program, ShaderName name, const T &value, Upload upload)
+{
+    static_assert(sizeof(T) <= SHADER_UNIFORM_VALUE_MAX, "uniform value too large to cache");
+
+    auto it = program->uniforms.find(name.hash);
+    if (it == program->uniforms.end())
+        return;
+
+    ShaderUniform &uniform = it->second;
+    if (uniform.cached && memcmp(uniform.value, &value, sizeof(T)) == 0)
+        return;
+
+    memcpy(uniform.value, &value, sizeof(T));
+    uniform.cached = true;
+    upload(program->id, uniform.location);
+}
+
+template <>
+void SetUniform<float>(ShaderProgram *program, ShaderName name, const float &value)
+{
+    UploadUniform(program, name, value, [&](u32 id, i32 loc)
+                  { glProgramUniform1f(id, loc, value); });
+}
+
+template <>
+void SetUniform<int>(ShaderProgram *program, ShaderName name, const int &value)
+{
+    UploadUniform(program, name, value, [&](u32 id, i32 loc)
+                  { glProgramUniform1i(id, loc, value); });
+}
+
+template <>
+void SetUniform<bool>(ShaderProgram *program, ShaderName name, const bool &value)
+{
+    i32 asInt = value;
+    UploadUniform(program, name, asInt, [&](u32 id, i32 loc)
+                  { glProgramUniform1i(id, loc, asInt); });
 }
 
 template <>
-void SetUniform<float>(u32 program, str name, float value)
+void SetUniform<vec2>(ShaderProgram *program, ShaderName name, const vec2 &value)
 {
-    u32 loc = glGetUniformLocation(program, name);
-    glUniform1f(loc, value);
+    UploadUniform(program, name, value, [&](u32 id, i32 loc)
+                  { glProgramUniform2f(id, loc, value.x, value.y); });
 }
 
 template <>
-void SetUniform<int>(u32 program, str name, int value)
+void SetUniform<vec3>(ShaderProgram *program, ShaderName name, const vec3 &value)
 {
-    u32 loc = glGetUniformLocation(program, name);
-    glUniform1i(loc, value);
+    UploadUniform(program, name, value, [&](u32 id, i32 loc)
+                  { glProgramUniform3f(id, loc, value.x, value.y, value.z); });
 }
 
 template <>
-void SetUniform<bool>(u32 program, str name, bool value)
+void SetUniform<vec4>(ShaderProgram *program, ShaderName name, const vec4 &value)
 {
-    u32 loc = glGetUniformLocation(program, name);
-    glUniform1i(loc, value);
+    UploadUniform(program, name, value, [&](u32 id, i32 loc)
+                  { glProgramUniform4f(id, loc, value.x, value.y, value.z, value.w); });
 }
 
 template <>
-void SetUniform<mat4>(u32 program, str name, mat4 value)
+void SetUniform<mat3>(ShaderProgram *program, ShaderName name, const mat3 &value)
 {
-    u32 loc = glGetUniformLocation(program, name);
-    glUniformMatrix4fv(loc, 1, GL_FALSE, value.m); // Changed GL_TRUE to GL_FALSE
-}
\ No newline at end of file
+    UploadUniform(program, name, value, [&](u32 id, i32 loc)
+                  { glProgramUniformMatrix3fv(id, loc, 1, GL_FALSE, value.m); });
+}
+
+template <>
+void SetUniform<mat4>(ShaderProgram *program, ShaderName name, const mat4 &value)
+{
+    UploadUniform(program, name, value, [&](u32 id, i32 loc)
+                  { glProgramUniformMatrix4fv(id, loc, 1, GL_FALSE, value.m); });
+}
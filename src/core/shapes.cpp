@@ -0,0 +1,280 @@
+#include <engine/shapes.h>
+#include <algorithm>
+
+#define MITER_LIMIT 4.0f // max miter length as a multiple of half the thickness
+
+static inline vec2 Perp(vec2 v)
+{
+    return vec2(-v.y, v.x);
+}
+
+static inline float Cross(vec2 a, vec2 b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+static inline vec2 Direction(vec2 from, vec2 to)
+{
+    return (to - from).Normalized();
+}
+
+void ReserveGeometry(Batch &b, size_t vertexCount, size_t indexCount)
+{
+    if (vertexCount > b.vertices.capacity())
+        b.vertices.reserve(std::max(vertexCount, b.vertices.capacity() * 2));
+    if (indexCount > b.indices.capacity())
+        b.indices.reserve(std::max(indexCount, b.indices.capacity() * 2));
+}
+
+GeometryWriter AllocGeometry(Batch &b, u32 vertexCount, u32 indexCount)
+{
+    u32 base = b.vertices.size();
+    size_t firstIndex = b.indices.size();
+
+    ReserveGeometry(b, base + vertexCount, firstIndex + indexCount);
+    b.vertices.resize(base + vertexCount);
+    b.indices.resize(firstIndex + indexCount);
+
+    return GeometryWriter{
+        .vertices = b.vertices.data() + base,
+        .indices = b.indices.data() + firstIndex,
+        .base = base};
+}
+
+// Writes a thick segment as a quad into v[0..3] / idx[0..5]
+static inline void WriteSegment(Vertex *v, u32 *idx, u32 base, vec2 p0, vec2 p1, float half, vec4 color)
+{
+    vec2 n = Perp(Direction(p0, p1)) * half;
+
+    v[0] = Vertex{.pos = p0 + n, .uv = vec2(0.0f), .color = color};
+    v[1] = Vertex{.pos = p0 - n, .uv = vec2(0.0f), .color = color};
+    v[2] = Vertex{.pos = p1 - n, .uv = vec2(0.0f), .color = color};
+    v[3] = Vertex{.pos = p1 + n, .uv = vec2(0.0f), .color = color};
+
+    idx[0] = base + 0;
+    idx[1] = base + 1;
+    idx[2] = base + 2;
+    idx[3] = base + 2;
+    idx[4] = base + 3;
+    idx[5] = base + 0;
+}
+
+void DrawLine(Batch &b, vec2 p0, vec2 p1, float thickness, vec4 color)
+{
+    GeometryWriter g = AllocGeometry(b, 4, 6);
+    WriteSegment(g.vertices, g.indices, g.base, p0, p1, thickness * 0.5f, color);
+}
+
+void DrawLines(Batch &b, const vec2 *points, u32 count, float thickness, vec4 color)
+{
+    u32 segments = count / 2;
+    if (!segments)
+        return;
+
+    float half = thickness * 0.5f;
+    GeometryWriter g = AllocGeometry(b, segments * 4, segments * 6);
+    for (u32 i = 0; i < segments; i++)
+    {
+        WriteSegment(
+            g.vertices + i * 4, g.indices + i * 6, g.base + i * 4,
+            points[i * 2], points[i * 2 + 1], half, color);
+    }
+}
+
+void DrawPolyline(Batch &b, const vec2 *points, u32 count, float thickness, vec4 color, LineJoin join, bool closed)
+{
+    if (count < 2)
+        return;
+    if (count == 2)
+        closed = false;
+
+    float half = thickness * 0.5f;
+    u32 segments = closed ? count : count - 1;
+
+    // Worst case every joint is a bevel: in-pair, center, out-pair + a wedge
+    size_t vertexStart = b.vertices.size();
+    size_t indexStart = b.indices.size();
+    GeometryWriter g = AllocGeometry(b, count * 5, segments * 6 + count * 3);
+    u32 vc = 0;
+    u32 ic = 0;
+
+    auto vert = [&](vec2 p) -> u32
+    {
+        g.vertices[vc] = Vertex{.pos = p, .uv = vec2(0.0f), .color = color};
+        return g.base + vc++;
+    };
+    auto tri = [&](u32 i0, u32 i1, u32 i2)
+    {
+        g.indices[ic++] = i0;
+        g.indices[ic++] = i1;
+        g.indices[ic++] = i2;
+    };
+
+    u32 firstL = 0, firstR = 0;
+    u32 prevL = 0, prevR = 0;
+    for (u32 i = 0; i < count; i++)
+    {
+        vec2 p = points[i];
+        bool hasPrev = closed || i > 0;
+        bool hasNext = closed || i + 1 < count;
+
+        u32 inL, inR, outL, outR;
+        if (!hasPrev || !hasNext)
+        {
+            // Butt cap at an open end
+            vec2 d = hasPrev ? Direction(points[i - 1], p) : Direction(p, points[i + 1]);
+            vec2 n = Perp(d) * half;
+            inL = outL = vert(p + n);
+            inR = outR = vert(p - n);
+        }
+        else
+        {
+            vec2 d0 = Direction(points[(i + count - 1) % count], p);
+            vec2 d1 = Direction(p, points[(i + 1) % count]);
+            vec2 n0 = Perp(d0);
+            vec2 n1 = Perp(d1);
+
+            // With unit normals, cos(half joint angle) = |n0 + n1| / 2
+            vec2 m = n0 + n1;
+            float mm = vec2::Dot(m, m);
+            if (join == JOIN_MITER && mm > 4.0f / (MITER_LIMIT * MITER_LIMIT))
+            {
+                vec2 miter = m * (2.0f * half / mm);
+                inL = outL = vert(p + miter);
+                inR = outR = vert(p - miter);
+            }
+            else
+            {
+                inL = vert(p + n0 * half);
+                inR = vert(p - n0 * half);
+                u32 c = vert(p);
+                outL = vert(p + n1 * half);
+                outR = vert(p - n1 * half);
+
+                // Fill the wedge on the outside of the turn
+                if (Cross(d0, d1) > 0.0f)
+                    tri(c, inR, outR);
+                else
+                    tri(c, outL, inL);
+            }
+        }
+
+        if (i > 0)
+        {
+            tri(prevL, prevR, inR);
+            tri(inR, inL, prevL);
+        }
+        else
+        {
+            firstL = inL;
+            firstR = inR;
+        }
+        prevL = outL;
+        prevR = outR;
+    }
+
+    if (closed)
+    {
+        tri(prevL, prevR, firstR);
+        tri(firstR, firstL, prevL);
+    }
+
+    // Give back the slots reserved for bevels that turned out to be miters
+    b.vertices.resize(vertexStart + vc);
+    b.indices.resize(indexStart + ic);
+}
+
+void DrawArc(Batch &b, vec2 center, float radius, float startAngle, float endAngle, float thickness, vec4 color, int segments)
+{
+    segments = std::max(segments, 1);
+    float half = thickness * 0.5f;
+    float inner = std::max(radius - half, 0.0f);
+    float outer = radius + half;
+
+    // Rotate a unit vector by a fixed step instead of calling cos/sin per point
+    float step = (endAngle - startAngle) / float(segments);
+    float cs = cosf(step);
+    float sn = sinf(step);
+    vec2 dir = vec2(cosf(startAngle), sinf(startAngle));
+
+    GeometryWriter g = AllocGeometry(b, (segments + 1) * 2, segments * 6);
+    for (int i = 0; i <= segments; i++)
+    {
+        g.vertices[i * 2 + 0] = Vertex{.pos = center + dir * outer, .uv = vec2(0.0f), .color = color};
+        g.vertices[i * 2 + 1] = Vertex{.pos = center + dir * inner, .uv = vec2(0.0f), .color = color};
+        dir = vec2(dir.x * cs - dir.y * sn, dir.x * sn + dir.y * cs);
+    }
+
+    for (int i = 0; i < segments; i++)
+    {
+        u32 o0 = g.base + i * 2;
+        u32 *idx = g.indices + i * 6;
+        idx[0] = o0;
+        idx[1] = o0 + 1;
+        idx[2] = o0 + 3;
+        idx[3] = o0 + 3;
+        idx[4] = o0 + 2;
+        idx[5] = o0;
+    }
+}
+
+void DrawRoundedRect(Batch &b, vec2 pos, vec2 size, float radius, vec4 color, int cornerSegments)
+{
+    cornerSegments = std::max(cornerSegments, 1);
+    radius = std::clamp(radius, 0.0f, std::min(size.x, size.y) * 0.5f);
+
+    u32 perCorner = cornerSegments + 1;
+    u32 perimeter = perCorner * 4;
+
+    // Corner arcs in counter-clockwise order, starting at the bottom-right
+    vec2 corners[4] = {
+        vec2(pos.x + size.x - radius, pos.y + radius),
+        vec2(pos.x + size.x - radius, pos.y + size.y - radius),
+        vec2(pos.x + radius, pos.y + size.y - radius),
+        vec2(pos.x + radius, pos.y + radius),
+    };
+
+    float step = 0.5f * 3.1415926f / float(cornerSegments);
+    float cs = cosf(step);
+    float sn = sinf(step);
+
+    GeometryWriter g = AllocGeometry(b, perimeter + 1, perimeter * 3);
+    g.vertices[0] = Vertex{.pos = pos + size * 0.5f, .uv = vec2(0.0f), .color = color};
+
+    Vertex *v = g.vertices + 1;
+    vec2 dir = vec2(0.0f, -1.0f);
+    for (int c = 0; c < 4; c++)
+    {
+        vec2 d = dir;
+        for (u32 i = 0; i < perCorner; i++)
+        {
+            *v++ = Vertex{.pos = corners[c] + d * radius, .uv = vec2(0.0f), .color = color};
+            d = vec2(d.x * cs - d.y * sn, d.x * sn + d.y * cs);
+        }
+        dir = Perp(dir); // next corner starts a quarter turn later
+    }
+
+    for (u32 i = 0; i < perimeter; i++)
+    {
+        g.indices[i * 3 + 0] = g.base;
+        g.indices[i * 3 + 1] = g.base + 1 + i;
+        g.indices[i * 3 + 2] = g.base + 1 + (i + 1 < perimeter ? i + 1 : 0);
+    }
+}
+
+void DrawConvexPolygon(Batch &b, const vec2 *points, u32 count, vec4 color)
+{
+    if (count < 3)
+        return;
+
+    GeometryWriter g = AllocGeometry(b, count, (count - 2) * 3);
+    for (u32 i = 0; i < count; i++)
+        g.vertices[i] = Vertex{.pos = points[i], .uv = vec2(0.0f), .color = color};
+
+    for (u32 i = 0; i < count - 2; i++)
+    {
+        g.indices[i * 3 + 0] = g.base;
+        g.indices[i * 3 + 1] = g.base + i + 1;
+        g.indices[i * 3 + 2] = g.base + i + 2;
+    }
+}
@@ -0,0 +1,369 @@
+#include <engine/text.h>
+#include <engine/memory.h>
+#include <platform/platform.h>
+#include <glad/glad.h>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+
+#include <algorithm>
+#include <string.h>
+
+#define TEXT_CACHE_MAX_AGE 120 // frames a shaped run survives without being used
+
+Font font;
+
+// Cache nodes are recycled through a pool, shaped runs come and go every frame
+typedef std::unordered_map<u64, ShapedRun, std::hash<u64>, std::equal_to<u64>,
+                           PoolStlAllocator<std::pair<const u64, ShapedRun>>> ShapedRunCache;
+
+static ShapedRunCache textCache; // keyed by text hash and wrap width
+static ShapedRunCache runCache;  // keyed by caller run id
+static u64 textFrame = 0;
+
+static inline u32 KerningKey(u8 left, u8 right)
+{
+    return ((u32)left << 8) | right;
+}
+
+static inline i32 GetKerning(u8 left, u8 right)
+{
+    if (font.kerning.empty())
+        return 0;
+    auto it = font.kerning.find(KerningKey(left, right));
+    return it != font.kerning.end() ? it->second : 0;
+}
+
+static inline u8 ToFontChar(char ch)
+{
+    u8 c = (u8)ch;
+    if (c == '\t')
+        return ' ';
+    if (c < FONT_FIRST_CHAR || c > FONT_LAST_CHAR)
+        return '?';
+    return c;
+}
+
+// FreeType allocations go through the tracker under the fonts tag
+static void *FontAlloc(FT_Memory, long size)
+{
+    return TrackedMalloc(MEM_FONTS, size);
+}
+
+static void FontFree(FT_Memory, void *block)
+{
+    TrackedFree(block);
+}
+
+static void *FontRealloc(FT_Memory, long, long newSize, void *block)
+{
+    return TrackedRealloc(MEM_FONTS, block, newSize);
+}
+
+static FT_MemoryRec_ fontMemory = {nullptr, FontAlloc, FontFree, FontRealloc};
+
+bool LoadFont(int width, VfsPath filepath)
+{
+    FT_Library ft;
+    if (FT_New_Library(&fontMemory, &ft))
+    {
+        printf("Failed to init FreeType\n");
+        return false;
+    }
+    FT_Add_Default_Modules(ft);
+
+    // FreeType reads glyph data straight from the file view, which has to
+    // stay alive until FT_Done_Face below
+    VfsFile file = VfsOpen(filepath, MAP_HINT_RANDOM);
+
+    FT_Face face;
+    if (!file.valid || FT_New_Memory_Face(ft, file.data, (FT_Long)file.size, 0, &face))
+    {
+        printf("Failed to load font\n");
+        FT_Done_Library(ft);
+        return false;
+    }
+
+    FT_Set_Pixel_Sizes(face, 0, 48); // height = 48px
+
+    font.lineHeight = face->size->metrics.height >> 6;
+    font.ascender = face->size->metrics.ascender >> 6;
+    font.descender = face->size->metrics.descender >> 6;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    int x = 0;
+    int y = 0;
+    int rowHeight = 0;
+    int padding = 2;
+
+    for (unsigned char c = FONT_FIRST_CHAR; c <= FONT_LAST_CHAR; c++)
+    {
+        Glyph &g = font.glyphs[c - FONT_FIRST_CHAR];
+        g = Glyph{};
+
+        if (FT_Load_Char(face, c, FT_LOAD_RENDER))
+            continue;
+
+        if (x + face->glyph->bitmap.width + padding >= width)
+        {
+            x = 0;
+            y += rowHeight;
+            rowHeight = 0;
+        }
+
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            x,
+            y,
+            face->glyph->bitmap.width,
+            face->glyph->bitmap.rows,
+            GL_RED,
+            GL_UNSIGNED_BYTE,
+            face->glyph->bitmap.buffer);
+
+        g.size = ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows);
+        g.bearing = ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top);
+        g.advance = face->glyph->advance.x;
+        g.atlasPos = ivec2(x, y);
+
+        rowHeight = std::max(rowHeight,
+                             static_cast<int>(face->glyph->bitmap.rows) + padding);
+        x += face->glyph->bitmap.width + padding;
+    }
+
+    // Precompute kerning for every printable pair so layout never calls into FreeType
+    font.kerning.clear();
+    if (FT_HAS_KERNING(face))
+    {
+        FT_UInt indices[FONT_CHAR_COUNT];
+        for (int c = FONT_FIRST_CHAR; c <= FONT_LAST_CHAR; c++)
+            indices[c - FONT_FIRST_CHAR] = FT_Get_Char_Index(face, c);
+
+        for (int l = 0; l < FONT_CHAR_COUNT; l++)
+        {
+            for (int r = 0; r < FONT_CHAR_COUNT; r++)
+            {
+                FT_Vector delta;
+                if (FT_Get_Kerning(face, indices[l], indices[r], FT_KERNING_DEFAULT, &delta))
+                    continue;
+                if (delta.x >> 6)
+                    font.kerning[KerningKey(l + FONT_FIRST_CHAR, r + FONT_FIRST_CHAR)] = (i32)(delta.x >> 6);
+            }
+        }
+    }
+
+    FT_Done_Face(face);
+    FT_Done_Library(ft);
+
+    textCache.clear();
+    runCache.clear();
+    return true;
+}
+
+// ---------------- Shaping ----------------
+static void ShapeRun(ShapedRun &run, std::string_view text, float maxWidth)
+{
+    run.text.assign(text.data(), text.size());
+    run.maxWidth = maxWidth;
+    run.glyphs.clear();
+    run.lines.clear();
+    run.width = 0.0f;
+
+    float pen = 0.0f;
+    u8 prev = 0;
+    u32 lineStart = 0;
+
+    // Last space on the current line, where a greedy wrap can happen
+    i32 breakGlyph = -1;
+    float breakWidth = 0.0f; // line width before the space
+    float breakPen = 0.0f;   // pen position after the space
+
+    auto closeLine = [&](u32 end, float width)
+    {
+        run.lines.push_back(TextLine{lineStart, end - lineStart, width});
+        run.width = std::max(run.width, width);
+        lineStart = end;
+        breakGlyph = -1;
+    };
+
+    for (char ch : text)
+    {
+        if (ch == '\n')
+        {
+            closeLine((u32)run.glyphs.size(), pen);
+            pen = 0.0f;
+            prev = 0;
+            continue;
+        }
+
+        u8 c = ToFontChar(ch);
+        const Glyph &g = font.glyphs[c - FONT_FIRST_CHAR];
+        float kern = prev ? (float)GetKerning(prev, c) : 0.0f;
+        float advance = (float)(g.advance >> 6);
+
+        while (maxWidth > 0.0f && c != ' ' && pen > 0.0f && pen + kern + advance > maxWidth)
+        {
+            if (breakGlyph >= 0)
+            {
+                // Wrap at the last space: drop it and move the tail to a new line
+                closeLine((u32)breakGlyph, breakWidth);
+                run.glyphs.erase(run.glyphs.begin() + breakGlyph);
+                for (size_t i = breakGlyph; i < run.glyphs.size(); i++)
+                    run.glyphs[i].x -= breakPen;
+                pen -= breakPen;
+            }
+            else
+            {
+                // Single word wider than the line, break it mid-word
+                closeLine((u32)run.glyphs.size(), pen);
+                pen = 0.0f;
+                prev = 0;
+                kern = 0.0f;
+            }
+        }
+
+        if (c == ' ')
+        {
+            breakGlyph = (i32)run.glyphs.size();
+            breakWidth = pen;
+        }
+
+        run.glyphs.push_back(ShapedGlyph{pen + kern, c});
+        pen += kern + advance;
+        prev = c;
+
+        if (c == ' ')
+            breakPen = pen;
+    }
+    closeLine((u32)run.glyphs.size(), pen);
+}
+
+const ShapedRun &ShapeText(std::string_view text, float maxWidth)
+{
+    u64 key = std::hash<std::string_view>{}(text);
+    u32 widthBits;
+    memcpy(&widthBits, &maxWidth, sizeof(widthBits));
+    key ^= (u64)widthBits * 0x9E3779B97F4A7C15ull;
+
+    ShapedRun &run = textCache[key];
+    if (run.lines.empty() || run.maxWidth != maxWidth || run.text != text)
+        ShapeRun(run, text, maxWidth);
+
+    run.lastUsedFrame = textFrame;
+    return run;
+}
+
+const ShapedRun &ShapeText(u64 runId, u64 version, std::string_view text, float maxWidth)
+{
+    // Nothing here is proportional to the text unless it has to be reshaped
+    ShapedRun &run = runCache[runId];
+    if (run.lines.empty() || run.maxWidth != maxWidth || run.version != version)
+    {
+        ShapeRun(run, text, maxWidth);
+        run.version = version;
+    }
+
+    run.lastUsedFrame = textFrame;
+    return run;
+}
+
+vec2 MeasureText(std::string_view text, float scale, float maxWidth)
+{
+    const ShapedRun &run = ShapeText(text, maxWidth / scale);
+    return vec2(run.width * scale, (float)(run.lines.size() * font.lineHeight) * scale);
+}
+
+// ---------------- Emitting ----------------
+void RenderTextRun(const ShapedRun &run, float x, float y, float scale, vec4 color, Rect clip)
+{
+    if (run.lines.empty())
+        return;
+
+    float lineHeight = font.lineHeight * scale;
+    float ascender = font.ascender * scale;
+    float descender = font.descender * scale;
+    i32 lineCount = (i32)run.lines.size();
+
+    // Line i has its baseline at y - i * lineHeight. Solve for the range of
+    // lines whose [descender, ascender] span overlaps the clip rect.
+    i32 first = lineCount;
+    i32 last = -1;
+    if (lineHeight > 0.0f)
+    {
+        first = std::max(0, (i32)ceilf((y + descender - clip.max.y) / lineHeight));
+        last = std::min(lineCount - 1, (i32)floorf((y + ascender - clip.min.y) / lineHeight));
+    }
+
+    Batch &b = batches[1];
+    for (i32 i = first; i <= last; i++)
+    {
+        const TextLine &line = run.lines[i];
+        float baseline = y - i * lineHeight;
+
+        for (u32 j = line.first; j < line.first + line.count; j++)
+        {
+            const ShapedGlyph &sg = run.glyphs[j];
+            const Glyph &g = font.glyphs[sg.c - FONT_FIRST_CHAR];
+
+            float xpos = x + (sg.x + g.bearing.x) * scale;
+            if (xpos > clip.max.x)
+                break; // glyphs only move right along a line
+            float w = g.size.x * scale;
+            if (w <= 0.0f || xpos + w < clip.min.x)
+                continue;
+
+            float ypos = baseline - (g.size.y - g.bearing.y) * scale;
+            float h = g.size.y * scale;
+
+            DrawQuad(
+                b,
+                vec2(xpos, ypos),
+                vec2(w, h),
+                g.atlasPos,
+                g.size,
+                color);
+        }
+    }
+}
+
+void RenderText(std::string_view text, float x, float y, float scale, vec4 color)
+{
+    Rect screen{vec2(0.0f), vec2(input->screen)};
+    RenderTextRun(ShapeText(text), x, y, scale, color, screen);
+}
+
+static void RenderTextBoxRun(const ShapedRun &run, Rect box, float scale, vec4 color, float scrollY)
+{
+    float baseline = box.max.y - font.ascender * scale + scrollY;
+    RenderTextRun(run, box.min.x, baseline, scale, color, box);
+}
+
+void RenderTextBox(std::string_view text, Rect box, float scale, vec4 color, float scrollY)
+{
+    RenderTextBoxRun(ShapeText(text, (box.max.x - box.min.x) / scale), box, scale, color, scrollY);
+}
+
+void RenderTextBox(u64 runId, u64 version, std::string_view text, Rect box, float scale, vec4 color, float scrollY)
+{
+    RenderTextBoxRun(ShapeText(runId, version, text, (box.max.x - box.min.x) / scale), box, scale, color, scrollY);
+}
+
+void EndTextFrame()
+{
+    textFrame++;
+    if (textFrame % TEXT_CACHE_MAX_AGE)
+        return;
+
+    for (ShapedRunCache *cache : {&textCache, &runCache})
+    {
+        for (auto it = cache->begin(); it != cache->end();)
+        {
+            if (textFrame - it->second.lastUsedFrame > TEXT_CACHE_MAX_AGE)
+                it = cache->erase(it);
+            else
+                ++it;
+        }
+    }
+}
@@ -0,0 +1,619 @@
+#include <engine/texture.h>
+#include <engine/image.h>
+#include <engine/watch.h>
+#include <glad/glad.h>
+#include <stb/stb_image.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+struct Texture
+{
+    u32 id = 0; // 0 until the first upload finishes
+    i32 width = 0;
+    i32 height = 0;
+    TextureState state = TEXTURE_LOADING;
+    TextureFilter filter = TEXTURE_FILTER_NEAREST;
+    std::string path;
+    u32 generation = 0; // bumped by every (re)load; older images are dropped
+    u32 pending = 0;    // loads in flight, counted in pendingCount
+    i32 watchId = -1;
+};
+
+struct DecodeJob
+{
+    TextureHandle handle;
+    u32 generation;
+    std::string path;
+};
+
+// S3TC isn't core GL; every desktop driver exposes it as an extension
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+// Handed from a worker to the render thread. Cooked textures point their
+// levels into `source`; decoded ones own `pixels` plus a block of mips built
+// on the worker, since glGenerateMipmap can stall the render thread for tens
+// of milliseconds on some drivers. Everything is premultiplied.
+struct DecodedImage
+{
+    DecodedImage *next;
+    TextureHandle handle;
+    u32 generation;
+    bool valid;
+    u32 format; // CtexFormat
+    i32 width;
+    i32 height;
+    i32 levelCount;
+    const u8 *levels[IMAGE_MAX_LEVELS];
+
+    VfsFile source; // cooked file, mapped
+    u8 *pixels;     // level 0, owned by stb_image
+    u8 *mips;       // levels 1.., one tracked block
+
+    u32 target; // GL texture being filled, swapped in once complete
+};
+
+// Render thread only
+static Pool<Texture> *textures;
+static u32 placeholderId;
+static ivec2 placeholderSize;
+static std::deque<DecodedImage *> uploadQueue;
+static i32 uploadLevel; // progress through uploadQueue.front()
+static i32 uploadRow;
+static std::atomic<u32> pendingCount{0};
+static bool hasS3tc; // set before the workers start
+
+static u32 stagingBuffer;
+static u8 *stagingMemory;
+static GLsync stagingFences[TEXTURE_STAGING_SLICES];
+static u32 nextSlice;
+
+// Workers
+static array<std::thread> workers;
+static std::deque<DecodeJob> jobs;
+static std::mutex jobMutex;
+static std::condition_variable jobSignal;
+static bool stopWorkers;
+
+// Lock-free multi-producer / single-consumer stack of decoded images
+static std::atomic<DecodedImage *> decodedHead{nullptr};
+
+// ---------------- Decoded queue ----------------
+
+static void PushDecoded(DecodedImage *image)
+{
+    image->next = decodedHead.load(std::memory_order_relaxed);
+    while (!decodedHead.compare_exchange_weak(image->next, image, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+
+// The consumer takes the whole stack at once, so there is no ABA; reversing
+// it restores submission order
+static DecodedImage *TakeDecoded()
+{
+    DecodedImage *list = decodedHead.exchange(nullptr, std::memory_order_acquire);
+    DecodedImage *ordered = nullptr;
+    while (list)
+    {
+        DecodedImage *next = list->next;
+        list->next = ordered;
+        ordered = list;
+        list = next;
+    }
+    return ordered;
+}
+
+static void FreeDecoded(DecodedImage *image)
+{
+    glDeleteTextures(1, &image->target);
+    stbi_image_free(image->pixels);
+    TrackedFree(image->mips);
+    delete image;
+}
+
+static bool BuildMips(DecodedImage *image)
+{
+    image->levelCount = MipLevelCount(image->width, image->height);
+    image->levels[0] = image->pixels;
+
+    size_t mipBytes = 0;
+    for (i32 level = 1; level < image->levelCount; level++)
+        mipBytes += (size_t)MipSize(image->width, level) * MipSize(image->height, level) * 4;
+    if (!mipBytes)
+        return true;
+
+    image->mips = (u8 *)TrackedMalloc(MEM_ASSETS, mipBytes);
+    if (!image->mips)
+        return false;
+
+    u8 *at = image->mips;
+    for (i32 level = 1; level < image->levelCount; level++)
+    {
+        image->levels[level] = at;
+        DownsampleRGBA8(image->levels[level - 1], MipSize(image->width, level - 1), MipSize(image->height, level - 1), at);
+        at += (size_t)MipSize(image->width, level) * MipSize(image->height, level) * 4;
+    }
+    return true;
+}
+
+// "dir/name.png" -> "dir/name.ctex", the output path of tools/texcook
+static std::string CookedPath(const std::string &path)
+{
+    size_t slash = path.find_last_of('/');
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        dot = path.size();
+    return path.substr(0, dot) + ".ctex";
+}
+
+static bool LoadCooked(DecodedImage *image, const std::string &path)
+{
+    VfsFile file = VfsOpen(VfsPath(path.c_str()));
+    if (!file.valid)
+        return false;
+
+    const CtexHeader *header = ParseCtex(file.Span());
+    if (!header)
+    {
+        print("Invalid cooked texture: %s", path.c_str());
+        return false;
+    }
+    if (header->format != CTEX_FORMAT_RGBA8 && !hasS3tc)
+        return false; // fall back to the source image
+
+    image->format = header->format;
+    image->width = header->width;
+    image->height = header->height;
+    image->levelCount = header->levelCount;
+    for (u32 level = 0; level < header->levelCount; level++)
+        image->levels[level] = file.data + header->levels[level].offset;
+    image->source = std::move(file);
+    return true;
+}
+
+static bool DecodeSource(DecodedImage *image, const std::string &path)
+{
+    VfsFile file = VfsOpen(VfsPath(path.c_str()));
+    if (!file.valid)
+        return false;
+
+    int channels;
+    image->pixels = stbi_load_from_memory(file.data, (int)file.size, &image->width, &image->height, &channels, 4);
+    if (!image->pixels)
+        return false;
+
+    image->format = CTEX_FORMAT_RGBA8;
+    PremultiplyAlpha(image->pixels, (size_t)image->width * image->height);
+    return BuildMips(image);
+}
+
+// ---------------- Workers ----------------
+
+static void DecodeWorker()
+{
+    for (;;)
+    {
+        DecodeJob job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobSignal.wait(lock, []
+                           { return stopWorkers || !jobs.empty(); });
+            if (stopWorkers)
+                return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        DecodedImage *image = new DecodedImage{};
+        image->handle = job.handle;
+        image->generation = job.generation;
+
+        // A cooked version skips decoding entirely; lookups of missing ones are cached
+        std::string cooked = CookedPath(job.path);
+        image->valid = LoadCooked(image, cooked) || (cooked != job.path && DecodeSource(image, job.path));
+        if (!image->valid)
+            print("Failed to load texture: %s", job.path.c_str());
+
+        PushDecoded(image);
+    }
+}
+
+// ---------------- GL helpers ----------------
+
+static void SetSampling(TextureFilter filter)
+{
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    if (filter == TEXTURE_FILTER_NEAREST)
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+    else
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+}
+
+static bool LoadPlaceholder()
+{
+    VfsFile file = VfsOpen(TEXTURE_PLACEHOLDER_PATH);
+    int channels;
+    u8 *pixels = file.valid ? stbi_load_from_memory(file.data, (int)file.size, &placeholderSize.x, &placeholderSize.y, &channels, 4) : nullptr;
+    if (!pixels)
+    {
+        print("Failed to load placeholder texture: %s", TEXTURE_PLACEHOLDER_PATH);
+        return false;
+    }
+
+    glGenTextures(1, &placeholderId);
+    glBindTexture(GL_TEXTURE_2D, placeholderId);
+    SetSampling(TEXTURE_FILTER_NEAREST);
+    PremultiplyAlpha(pixels, (size_t)placeholderSize.x * placeholderSize.y);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, placeholderSize.x, placeholderSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    stbi_image_free(pixels);
+    return true;
+}
+
+// ---------------- Lifetime ----------------
+
+bool InitTextures(u32 workerCount)
+{
+    textures = new Pool<Texture>(TEXTURE_MAX_COUNT);
+
+    // One persistently mapped buffer split into slices; a slice is reused
+    // once the fence of the upload that last read from it has signaled
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &stagingBuffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, TEXTURE_STAGING_SLICE * TEXTURE_STAGING_SLICES, nullptr, flags);
+    stagingMemory = (u8 *)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, TEXTURE_STAGING_SLICE * TEXTURE_STAGING_SLICES, flags);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (!stagingMemory)
+    {
+        print("Failed to map texture staging buffer");
+        return false;
+    }
+
+    i32 extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (i32 i = 0; i < extensionCount; i++)
+        hasS3tc |= strcmp((const char *)glGetStringi(GL_EXTENSIONS, i), "GL_EXT_texture_compression_s3tc") == 0;
+
+    stopWorkers = false;
+    for (u32 i = 0; i < std::max(workerCount, 1u); i++)
+        workers.emplace_back(DecodeWorker);
+
+    return LoadPlaceholder();
+}
+
+void ShutdownTextures()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopWorkers = true;
+        jobs.clear();
+    }
+    jobSignal.notify_all();
+    for (std::thread &worker : workers)
+        worker.join();
+    workers.clear();
+
+    for (DecodedImage *image = TakeDecoded(); image;)
+    {
+        DecodedImage *next = image->next;
+        FreeDecoded(image);
+        image = next;
+    }
+    for (DecodedImage *image : uploadQueue)
+        FreeDecoded(image);
+    uploadQueue.clear();
+    uploadLevel = 0;
+    uploadRow = 0;
+    pendingCount = 0;
+
+    for (GLsync &fence : stagingFences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (stagingBuffer)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glDeleteBuffers(1, &stagingBuffer);
+    }
+    stagingBuffer = 0;
+    stagingMemory = nullptr;
+
+    if (textures)
+    {
+        textures->ForEach([](TextureHandle, Texture &texture)
+                          {
+                              UnwatchAsset(texture.watchId);
+                              glDeleteTextures(1, &texture.id); });
+        delete textures;
+        textures = nullptr;
+    }
+
+    glDeleteTextures(1, &placeholderId);
+    placeholderId = 0;
+}
+
+static void QueueDecode(TextureHandle handle, Texture *texture)
+{
+    texture->generation++;
+    texture->pending++;
+    pendingCount++;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobs.push_back(DecodeJob{handle, texture->generation, texture->path});
+    }
+    jobSignal.notify_one();
+}
+
+// A changed source or cooked file is decoded again in the background; the
+// old texture keeps drawing until the new one has been uploaded in full
+static void ReloadTexture(TextureHandle handle)
+{
+    Texture *texture = textures->Get(handle);
+    if (texture)
+        QueueDecode(handle, texture);
+}
+
+TextureHandle LoadTextureAsync(VfsPath path, TextureFilter filter)
+{
+    TextureHandle handle = textures->Create();
+    Texture *texture = textures->Get(handle);
+    if (!texture)
+        return handle;
+    texture->filter = filter;
+    texture->path = path.path;
+    texture->watchId = WatchAssets({texture->path, CookedPath(texture->path)}, [handle]
+                                   { ReloadTexture(handle); });
+
+    QueueDecode(handle, texture);
+    return handle;
+}
+
+void DestroyTexture(TextureHandle handle)
+{
+    Texture *texture = textures->Get(handle);
+    if (!texture)
+        return;
+
+    // A load still in flight is dropped when its image reaches the render thread
+    pendingCount -= texture->pending;
+    UnwatchAsset(texture->watchId);
+    glDeleteTextures(1, &texture->id);
+    textures->Destroy(handle);
+}
+
+TextureState GetTextureState(TextureHandle handle)
+{
+    Texture *texture = textures->Get(handle);
+    return texture ? texture->state : TEXTURE_FAILED;
+}
+
+u32 GetTextureId(TextureHandle handle)
+{
+    Texture *texture = textures->Get(handle);
+    return texture && texture->id ? texture->id : placeholderId;
+}
+
+ivec2 GetTextureSize(TextureHandle handle)
+{
+    Texture *texture = textures->Get(handle);
+    return texture && texture->id ? ivec2(texture->width, texture->height) : placeholderSize;
+}
+
+// ---------------- Upload ----------------
+
+static double NowMs()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static u32 InternalFormat(u32 format)
+{
+    switch (format)
+    {
+        case CTEX_FORMAT_BC1:
+            return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case CTEX_FORMAT_BC3:
+            return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        default:
+            return GL_RGBA8;
+    }
+}
+
+// Claims the next staging slice if the GPU is done reading it
+static bool AcquireSlice(u32 *slice)
+{
+    GLsync &fence = stagingFences[nextSlice];
+    if (fence)
+    {
+        GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (status == GL_TIMEOUT_EXPIRED)
+            return false;
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    *slice = nextSlice;
+    nextSlice = (nextSlice + 1) % TEXTURE_STAGING_SLICES;
+    return true;
+}
+
+// A failed reload keeps the texture it already has
+static void FinishUpload(Texture *texture, TextureState state)
+{
+    if (state == TEXTURE_READY || !texture->id)
+        texture->state = state;
+    texture->pending--;
+    pendingCount--;
+}
+
+void UpdateTextures(double budgetMs)
+{
+    double start = NowMs();
+
+    for (DecodedImage *image = TakeDecoded(); image;)
+    {
+        DecodedImage *next = image->next;
+        Texture *texture = textures->Get(image->handle);
+        if (!texture)
+        {
+            FreeDecoded(image); // destroyed while decoding
+        }
+        else if (image->generation != texture->generation)
+        {
+            // Superseded by a reload queued after it
+            texture->pending--;
+            pendingCount--;
+            FreeDecoded(image);
+        }
+        else if (!image->valid || (size_t)image->width * 4 > TEXTURE_STAGING_SLICE)
+        {
+            FinishUpload(texture, TEXTURE_FAILED);
+            FreeDecoded(image);
+        }
+        else
+        {
+            if (!texture->id)
+                texture->state = TEXTURE_UPLOADING;
+            uploadQueue.push_back(image);
+        }
+        image = next;
+    }
+
+    bool bound = false;
+    while (!uploadQueue.empty() && NowMs() - start < budgetMs)
+    {
+        DecodedImage *image = uploadQueue.front();
+        Texture *texture = textures->Get(image->handle);
+        if (!texture || image->generation != texture->generation)
+        {
+            // Destroyed, or reloaded again since this image was queued. A
+            // partly filled target goes with the image.
+            if (texture)
+            {
+                texture->pending--;
+                pendingCount--;
+            }
+            FreeDecoded(image);
+            uploadQueue.pop_front();
+            uploadLevel = 0;
+            uploadRow = 0;
+            continue;
+        }
+
+        u32 slice;
+        if (!AcquireSlice(&slice))
+            break; // every slice is still being read; try again next frame
+
+        if (!bound)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+            bound = true;
+        }
+
+        if (!image->target)
+        {
+            // Immutable storage up front, so each slice is a plain sub-upload.
+            // A reload fills a new texture, the current one stays drawable.
+            glGenTextures(1, &image->target);
+            glBindTexture(GL_TEXTURE_2D, image->target);
+            glTexStorage2D(GL_TEXTURE_2D, image->levelCount, InternalFormat(image->format), image->width, image->height);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image->levelCount - 1);
+            SetSampling(texture->filter);
+        }
+        else
+        {
+            glBindTexture(GL_TEXTURE_2D, image->target);
+        }
+
+        // Fill the slice with as many rows as fit, spilling into the next
+        // (smaller) levels, then fence it once. Block-compressed rows are
+        // rows of 4x4 blocks.
+        u32 blockBytes = CtexBlockBytes(image->format);
+        i32 rowTexels = blockBytes ? 4 : 1;
+        size_t sliceStart = (size_t)slice * TEXTURE_STAGING_SLICE;
+        size_t used = 0;
+        while (uploadLevel < image->levelCount)
+        {
+            i32 w = MipSize(image->width, uploadLevel);
+            i32 h = MipSize(image->height, uploadLevel);
+            size_t rowBytes = blockBytes ? (size_t)((w + 3) / 4) * blockBytes : (size_t)w * 4;
+            i32 rowCount = (h + rowTexels - 1) / rowTexels;
+            i32 rows = std::min<i32>((TEXTURE_STAGING_SLICE - used) / rowBytes, rowCount - uploadRow);
+            if (rows <= 0)
+                break;
+
+            size_t size = rows * rowBytes;
+            void *offset = (void *)(uintptr_t)(sliceStart + used);
+            i32 y = uploadRow * rowTexels;
+            i32 height = std::min(rows * rowTexels, h - y);
+            memcpy(stagingMemory + sliceStart + used, image->levels[uploadLevel] + uploadRow * rowBytes, size);
+            if (blockBytes)
+                glCompressedTexSubImage2D(GL_TEXTURE_2D, uploadLevel, 0, y, w, height, InternalFormat(image->format), (i32)size, offset);
+            else
+                glTexSubImage2D(GL_TEXTURE_2D, uploadLevel, 0, y, w, height, GL_RGBA, GL_UNSIGNED_BYTE, offset);
+            used += size;
+
+            uploadRow += rows;
+            if (uploadRow == rowCount)
+            {
+                uploadLevel++;
+                uploadRow = 0;
+            }
+        }
+        stagingFences[slice] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        if (uploadLevel == image->levelCount)
+        {
+            glDeleteTextures(1, &texture->id);
+            texture->id = image->target;
+            texture->width = image->width;
+            texture->height = image->height;
+            image->target = 0;
+            FinishUpload(texture, TEXTURE_READY);
+
+            FreeDecoded(image);
+            uploadQueue.pop_front();
+            uploadLevel = 0;
+            uploadRow = 0;
+        }
+    }
+
+    if (bound)
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+bool TexturesPending()
+{
+    return pendingCount > 0;
+}
+
+void FlushTextures()
+{
+    while (pendingCount > 0)
+    {
+        UpdateTextures(1e9);
+        if (pendingCount > 0)
+            std::this_thread::yield();
+    }
+}
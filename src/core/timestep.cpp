@@ -0,0 +1,47 @@
+#include <engine/timestep.h>
+#include <cmath>
+
+// ---------------- Fixed timestep ----------------
+
+void InitFixedTimestep(FixedTimestep *timestep, u32 tickRate, u32 maxSteps)
+{
+    Assert(tickRate > 0 && maxSteps > 0, "Fixed timestep needs a tick rate and at least one step per frame");
+    *timestep = {};
+    timestep->step = 1.0 / tickRate;
+    timestep->maxSteps = maxSteps;
+}
+
+u32 AdvanceFixedTimestep(FixedTimestep *timestep, float deltaTime, const TickCallback &tick)
+{
+    if (deltaTime > 0.0f)
+        timestep->accumulator += deltaTime;
+
+    u32 steps = 0;
+    while (timestep->accumulator >= timestep->step && steps < timestep->maxSteps)
+    {
+        tick((float)timestep->step);
+        timestep->accumulator -= timestep->step;
+        timestep->tick++;
+        steps++;
+    }
+
+    if (timestep->accumulator >= timestep->step)
+    {
+        // Drop whole steps only; the fraction keeps alpha continuous
+        double dropped = std::floor(timestep->accumulator / timestep->step) * timestep->step;
+        timestep->accumulator -= dropped;
+        timestep->droppedTime += dropped;
+    }
+
+    timestep->alpha = (float)(timestep->accumulator / timestep->step);
+    return steps;
+}
+
+void RunFixedTicks(FixedTimestep *timestep, u64 ticks, const TickCallback &tick)
+{
+    for (u64 i = 0; i < ticks; i++)
+    {
+        tick((float)timestep->step);
+        timestep->tick++;
+    }
+}
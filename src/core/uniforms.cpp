@@ -0,0 +1,105 @@
+#include <engine/uniforms.h>
+#include <glad/glad.h>
+#include <string.h>
+
+static UniformBuffer frameBuffer;
+
+// ---------------- Uniform buffers ----------------
+
+bool CreateUniformBuffer(UniformBuffer *buffer, u32 binding, u32 size)
+{
+    i32 alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+    buffer->binding = binding;
+    buffer->blockSize = (size + alignment - 1) / alignment * alignment;
+    buffer->region = 0;
+
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    GLsizeiptr total = (GLsizeiptr)buffer->blockSize * UNIFORM_BUFFER_REGIONS;
+    glGenBuffers(1, &buffer->id);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer->id);
+    glBufferStorage(GL_UNIFORM_BUFFER, total, nullptr, flags);
+    buffer->memory = (u8 *)glMapBufferRange(GL_UNIFORM_BUFFER, 0, total, flags);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    if (!buffer->memory)
+    {
+        print("Failed to map uniform buffer (binding %u)", binding);
+        DestroyUniformBuffer(buffer);
+        return false;
+    }
+    return true;
+}
+
+void DestroyUniformBuffer(UniformBuffer *buffer)
+{
+    for (void *&fence : buffer->fences)
+    {
+        if (fence)
+            glDeleteSync((GLsync)fence);
+        fence = nullptr;
+    }
+    if (buffer->id)
+    {
+        if (buffer->memory)
+        {
+            glBindBuffer(GL_UNIFORM_BUFFER, buffer->id);
+            glUnmapBuffer(GL_UNIFORM_BUFFER);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &buffer->id);
+    }
+    buffer->id = 0;
+    buffer->memory = nullptr;
+}
+
+void UpdateUniformBuffer(UniformBuffer *buffer, const void *data, u32 size)
+{
+    Assert(size <= buffer->blockSize, "Uniform block larger than its buffer: %u > %u", size, buffer->blockSize);
+
+    // Everything submitted so far, including the draws reading the current
+    // region, is behind this fence
+    GLsync &previous = (GLsync &)buffer->fences[buffer->region];
+    if (previous)
+        glDeleteSync(previous);
+    previous = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    buffer->region = (buffer->region + 1) % UNIFORM_BUFFER_REGIONS;
+    GLsync &fence = (GLsync &)buffer->fences[buffer->region];
+    if (fence)
+    {
+        // Normally signaled long ago; only blocks when the GPU is frames behind
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    size_t offset = (size_t)buffer->region * buffer->blockSize;
+    memcpy(buffer->memory + offset, data, size);
+    glBindBufferRange(GL_UNIFORM_BUFFER, buffer->binding, buffer->id, offset, buffer->blockSize);
+}
+
+i32 UniformBlockBinding(std::string_view blockName)
+{
+    if (blockName == "FrameConstants")
+        return UNIFORM_BINDING_FRAME;
+    return -1;
+}
+
+// ---------------- Per-frame constants ----------------
+
+bool InitFrameConstants()
+{
+    return CreateUniformBuffer(&frameBuffer, UNIFORM_BINDING_FRAME, sizeof(FrameConstants));
+}
+
+void ShutdownFrameConstants()
+{
+    DestroyUniformBuffer(&frameBuffer);
+}
+
+void SetFrameConstants(const FrameConstants &constants)
+{
+    UpdateUniformBuffer(&frameBuffer, constants);
+}
@@ -0,0 +1,256 @@
+#include <engine/vfs.h>
+#include <engine/pack.h>
+#include <engine/memory.h>
+#include <string.h>
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+struct VfsMount
+{
+    i32 id;
+    i32 priority;
+    std::string directory;          // loose files, when pack is null
+    std::unique_ptr<PackFile> pack;
+
+    ~VfsMount()
+    {
+        if (pack)
+            ClosePack(pack.get());
+    }
+};
+
+// Where a path resolved to; mountId 0 caches a miss
+struct VfsLookup
+{
+    std::string path; // guards against hash collisions
+    i32 mountId;
+    std::shared_ptr<const VfsMount> mount;
+    const PackEntry *entry;
+};
+
+// Shared so an open in progress (and a pack-backed VfsFile) keeps its mount
+// alive through a concurrent unmount
+static array<std::shared_ptr<VfsMount>> mounts; // highest priority first
+static std::unordered_map<u64, VfsLookup> lookupCache;
+static std::mutex vfsMutex;
+static i32 nextMountId = 1;
+
+// ---------------- Mounting ----------------
+
+static i32 AddMount(std::shared_ptr<VfsMount> mount)
+{
+    std::lock_guard<std::mutex> lock(vfsMutex);
+
+    mount->id = nextMountId++;
+    i32 id = mount->id;
+
+    auto at = std::find_if(mounts.begin(), mounts.end(), [&](const std::shared_ptr<VfsMount> &m)
+                           { return m->priority <= mount->priority; });
+    mounts.insert(at, std::move(mount));
+
+    // A new mount can shadow anything, including cached misses
+    lookupCache.clear();
+    return id;
+}
+
+i32 VfsMountDirectory(str directory, i32 priority)
+{
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error))
+        return -1;
+
+    auto mount = std::make_shared<VfsMount>();
+    mount->priority = priority;
+    mount->directory = directory;
+    if (!mount->directory.empty() && mount->directory.back() != '/' && mount->directory.back() != '\\')
+        mount->directory.push_back('/');
+    return AddMount(std::move(mount));
+}
+
+i32 VfsMountPack(str packPath, i32 priority)
+{
+    auto mount = std::make_shared<VfsMount>();
+    mount->priority = priority;
+    mount->pack = std::make_unique<PackFile>();
+    if (!OpenPack(mount->pack.get(), packPath))
+        return -1;
+    return AddMount(std::move(mount));
+}
+
+void VfsUnmount(i32 mountId)
+{
+    std::lock_guard<std::mutex> lock(vfsMutex);
+
+    auto it = std::find_if(mounts.begin(), mounts.end(), [&](const std::shared_ptr<VfsMount> &m)
+                           { return m->id == mountId; });
+    if (it == mounts.end())
+        return;
+
+    mounts.erase(it);
+    lookupCache.clear();
+}
+
+void ShutdownVfs()
+{
+    std::lock_guard<std::mutex> lock(vfsMutex);
+    mounts.clear();
+    lookupCache = {};
+}
+
+void VfsInvalidate()
+{
+    std::lock_guard<std::mutex> lock(vfsMutex);
+    lookupCache.clear();
+}
+
+void VfsInvalidate(VfsPath path)
+{
+    std::lock_guard<std::mutex> lock(vfsMutex);
+    lookupCache.erase(path.hash);
+}
+
+// ---------------- Lookup ----------------
+
+// Caller holds vfsMutex
+static const VfsLookup &Resolve(VfsPath path)
+{
+    auto it = lookupCache.find(path.hash);
+    if (it != lookupCache.end())
+    {
+        Assert(it->second.path == path.path, "VFS hash collision: %s / %s", it->second.path.c_str(), path.path);
+        return it->second;
+    }
+
+    VfsLookup lookup = {path.path, 0, nullptr, nullptr};
+    std::string diskPath;
+    for (const auto &mount : mounts)
+    {
+        if (mount->pack)
+        {
+            lookup.entry = FindPackEntry(mount->pack.get(), path.hash, path.path);
+            if (lookup.entry)
+            {
+                lookup.mountId = mount->id;
+                lookup.mount = mount;
+                break;
+            }
+        }
+        else
+        {
+            diskPath.assign(mount->directory).append(path.path);
+            std::error_code error;
+            if (std::filesystem::is_regular_file(diskPath, error))
+            {
+                lookup.mountId = mount->id;
+                lookup.mount = mount;
+                break;
+            }
+        }
+    }
+
+    return lookupCache.emplace(path.hash, std::move(lookup)).first->second;
+}
+
+bool VfsExists(VfsPath path)
+{
+    std::lock_guard<std::mutex> lock(vfsMutex);
+    return Resolve(path).mountId != 0;
+}
+
+array<std::string> VfsDiskPaths(VfsPath path)
+{
+    std::lock_guard<std::mutex> lock(vfsMutex);
+    array<std::string> paths;
+    for (const auto &mount : mounts)
+    {
+        if (!mount->pack)
+            paths.push_back(mount->directory + path.path);
+    }
+    return paths;
+}
+
+VfsFile VfsOpen(VfsPath path, MapHint hint)
+{
+    // A counted reference, not the cached pointer: an unmount can run as
+    // soon as the lock is released
+    std::shared_ptr<const VfsMount> mount;
+    const PackEntry *entry;
+    {
+        std::lock_guard<std::mutex> lock(vfsMutex);
+        const VfsLookup &lookup = Resolve(path);
+        mount = lookup.mount;
+        entry = lookup.entry;
+    }
+
+    VfsFile file;
+    if (!mount)
+        return file;
+
+    if (!mount->pack)
+    {
+        file.mapping = MapFile((mount->directory + path.path).c_str(), hint);
+        file.data = file.mapping.data;
+        file.size = file.mapping.size;
+        file.valid = file.mapping.valid;
+        return file;
+    }
+
+    if (entry->compression == PACK_COMPRESSION_NONE)
+    {
+        std::span<const u8> data = GetPackEntryData(mount->pack.get(), entry);
+        file.data = data.data();
+        file.size = data.size();
+        file.valid = true;
+        file.pack = std::move(mount);
+        return file;
+    }
+
+    // Null-terminated so text assets can be used as C strings
+    file.owned = (u8 *)TrackedMalloc(MEM_ASSETS, entry->rawSize + 1);
+    if (!file.owned || !ReadPackEntry(mount->pack.get(), entry, file.owned))
+        return file;
+
+    file.owned[entry->rawSize] = 0;
+    file.data = file.owned;
+    file.size = entry->rawSize;
+    file.valid = true;
+    return file;
+}
+
+// ---------------- VfsFile ----------------
+
+VfsFile::~VfsFile()
+{
+    if (owned)
+        TrackedFree(owned);
+}
+
+VfsFile::VfsFile(VfsFile &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+VfsFile &VfsFile::operator=(VfsFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        if (owned)
+            TrackedFree(owned);
+
+        data = other.data;
+        size = other.size;
+        valid = other.valid;
+        mapping = std::move(other.mapping);
+        owned = other.owned;
+        pack = std::move(other.pack);
+
+        other.data = nullptr;
+        other.size = 0;
+        other.valid = false;
+        other.owned = nullptr;
+    }
+    return *this;
+}
@@ -0,0 +1,424 @@
+#include <engine/watch.h>
+#include <engine/memory.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <filesystem>
+#endif
+
+struct AssetWatch
+{
+    array<std::string> paths; // VFS paths, invalidated before the callback
+    array<std::string> diskPaths;
+    WatchCallback callback;
+};
+
+static std::unordered_map<i32, AssetWatch> watches;
+static std::unordered_map<std::string, array<i32>> diskWatches; // disk path -> watch ids
+static std::unordered_map<i32, double> pendingWatches;          // watch id -> debounce deadline
+static array<i32> readyWatches;
+static std::mutex watchMutex;
+static std::thread watchThread;
+static bool watcherRunning; // render thread
+static i32 nextWatchId = 1;
+
+#ifdef __linux__
+static int inotifyFd = -1;
+static int wakeFd = -1; // eventfd, signaled on shutdown
+static std::unordered_map<std::string, int> dirWatches; // directory -> inotify watch descriptor
+static std::unordered_map<int, std::string> watchedDirs;
+static std::unordered_set<std::string> wantedDirs;     // parents of watched files, existing or not
+#else
+static std::unordered_map<std::string, std::filesystem::file_time_type> modifiedTimes;
+static std::condition_variable stopSignal;
+static bool stopWatching;
+#endif
+
+static double NowMs()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ---------------- Debounce ----------------
+
+// Caller holds watchMutex. Every event pushes the deadline back, so a file
+// that is still being written reloads once, after it goes quiet.
+static void MarkChanged(const std::string &diskPath, double now)
+{
+    auto it = diskWatches.find(diskPath);
+    if (it == diskWatches.end())
+        return;
+    for (i32 id : it->second)
+        pendingWatches[id] = now + WATCH_DEBOUNCE_MS;
+}
+
+// Caller holds watchMutex. Moves watches whose deadline passed to the ready
+// list; returns the milliseconds until the next deadline, or -1 for none.
+static int PromoteDue(double now)
+{
+    double next = -1.0;
+    for (auto it = pendingWatches.begin(); it != pendingWatches.end();)
+    {
+        if (it->second <= now)
+        {
+            if (std::find(readyWatches.begin(), readyWatches.end(), it->first) == readyWatches.end())
+                readyWatches.push_back(it->first);
+            it = pendingWatches.erase(it);
+            continue;
+        }
+        if (next < 0.0 || it->second - now < next)
+            next = it->second - now;
+        ++it;
+    }
+    return next < 0.0 ? -1 : (int)std::ceil(next);
+}
+
+// ---------------- Backend ----------------
+
+#ifdef __linux__
+
+#define WATCH_DIR_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_CREATE)
+
+static std::string ParentDir(const std::string &path)
+{
+    size_t slash = path.find_last_of('/');
+    if (slash == std::string::npos)
+        return ".";
+    return slash ? path.substr(0, slash) : "/";
+}
+
+// Caller holds watchMutex
+static bool AddDirWatch(const std::string &dir)
+{
+    if (dirWatches.count(dir))
+        return true;
+    int wd = inotify_add_watch(inotifyFd, dir.c_str(), WATCH_DIR_EVENTS);
+    if (wd < 0)
+        return false;
+    dirWatches[dir] = wd;
+    watchedDirs[wd] = dir;
+    return true;
+}
+
+// Caller holds watchMutex. While `dir` doesn't exist its nearest existing
+// ancestor is watched instead; that ancestor's IN_CREATE events bring the
+// watch one level closer each time. True once `dir` itself is watched.
+static bool WatchDirectory(const std::string &dir)
+{
+    if (AddDirWatch(dir))
+        return true;
+    for (std::string parent = ParentDir(dir);; parent = ParentDir(parent))
+    {
+        if (AddDirWatch(parent) || parent == "." || parent == "/")
+            return false;
+    }
+}
+
+// Caller holds watchMutex. After a directory appeared or a watch went away:
+// watches what can be watched now. Files written into a directory before
+// its watch existed count as changed.
+static void WatchMissingDirs(double now)
+{
+    for (const std::string &dir : wantedDirs)
+    {
+        if (dirWatches.count(dir) || !WatchDirectory(dir))
+            continue;
+        for (const auto &[diskPath, ids] : diskWatches)
+        {
+            if (ParentDir(diskPath) == dir && access(diskPath.c_str(), F_OK) == 0)
+                MarkChanged(diskPath, now);
+        }
+    }
+}
+
+// Caller holds watchMutex. Watches the parent directory rather than the file
+// itself: editors that save by writing a temporary and renaming it over the
+// original replace the inode, which would silently drop a file watch.
+static void WatchDiskPath(const std::string &diskPath)
+{
+    std::string dir = ParentDir(diskPath);
+    if (wantedDirs.insert(dir).second)
+        WatchDirectory(dir);
+}
+
+static void UnwatchDiskPath(const std::string &)
+{
+    // Directory watches are cheap and likely shared; they live until shutdown
+}
+
+static void WatchThread()
+{
+    alignas(inotify_event) char buffer[4096];
+    int timeout = -1;
+    for (;;)
+    {
+        pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+        if (poll(fds, 2, timeout) < 0 && errno != EINTR)
+            return;
+        if (fds[1].revents & POLLIN)
+            return;
+
+        std::lock_guard<std::mutex> lock(watchMutex);
+        double now = NowMs();
+        bool rescan = false;
+        for (;;)
+        {
+            ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0)
+                break;
+
+            for (char *at = buffer; at < buffer + length;)
+            {
+                const inotify_event *event = (const inotify_event *)at;
+                at += sizeof(inotify_event) + event->len;
+
+                auto dir = watchedDirs.find(event->wd);
+                if (dir == watchedDirs.end())
+                    continue;
+
+                if (event->mask & IN_IGNORED)
+                {
+                    // Deleted (or unmounted): watch whatever is left of the path
+                    dirWatches.erase(dir->second);
+                    watchedDirs.erase(dir);
+                    rescan = true;
+                    continue;
+                }
+                if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+                    rescan = true;
+                if (event->len)
+                    MarkChanged(dir->second + '/' + event->name, now);
+            }
+        }
+        if (rescan)
+            WatchMissingDirs(now);
+        timeout = PromoteDue(now);
+    }
+}
+
+static bool StartBackend()
+{
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    wakeFd = eventfd(0, EFD_CLOEXEC);
+    if (inotifyFd < 0 || wakeFd < 0)
+    {
+        print("Failed to create inotify instance (errno %d)", errno);
+        if (inotifyFd >= 0)
+            close(inotifyFd);
+        if (wakeFd >= 0)
+            close(wakeFd);
+        inotifyFd = wakeFd = -1;
+        return false;
+    }
+    return true;
+}
+
+static void StopBackend()
+{
+    u64 one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0)
+        print("Failed to wake the file watcher (errno %d)", errno);
+    watchThread.join();
+
+    close(inotifyFd);
+    close(wakeFd);
+    inotifyFd = wakeFd = -1;
+    dirWatches.clear();
+    watchedDirs.clear();
+    wantedDirs.clear();
+}
+
+#else
+
+static std::filesystem::file_time_type ModifiedTime(const std::string &diskPath)
+{
+    std::error_code error;
+    std::filesystem::file_time_type time = std::filesystem::last_write_time(diskPath, error);
+    return error ? std::filesystem::file_time_type::min() : time;
+}
+
+// Caller holds watchMutex
+static void WatchDiskPath(const std::string &diskPath)
+{
+    if (!modifiedTimes.count(diskPath))
+        modifiedTimes[diskPath] = ModifiedTime(diskPath);
+}
+
+static void UnwatchDiskPath(const std::string &diskPath)
+{
+    if (!diskWatches.count(diskPath))
+        modifiedTimes.erase(diskPath);
+}
+
+// No change notifications to wait on: stat every watched file each interval.
+// A missing file has the minimum time, so creating or deleting it counts too.
+static void WatchThread()
+{
+    std::unique_lock<std::mutex> lock(watchMutex);
+    while (!stopSignal.wait_for(lock, std::chrono::milliseconds(WATCH_POLL_MS), []
+                                { return stopWatching; }))
+    {
+        double now = NowMs();
+        for (auto &[diskPath, time] : modifiedTimes)
+        {
+            std::filesystem::file_time_type current = ModifiedTime(diskPath);
+            if (current != time)
+            {
+                time = current;
+                MarkChanged(diskPath, now);
+            }
+        }
+        PromoteDue(now);
+    }
+}
+
+static bool StartBackend()
+{
+    stopWatching = false;
+    return true;
+}
+
+static void StopBackend()
+{
+    {
+        std::lock_guard<std::mutex> lock(watchMutex);
+        stopWatching = true;
+    }
+    stopSignal.notify_all();
+    watchThread.join();
+    modifiedTimes.clear();
+}
+
+#endif
+
+// ---------------- Lifetime ----------------
+
+bool InitFileWatcher()
+{
+    if (watcherRunning)
+        return true;
+    if (!StartBackend())
+        return false;
+
+    watchThread = std::thread(WatchThread);
+    watcherRunning = true;
+    return true;
+}
+
+void ShutdownFileWatcher()
+{
+    if (!watcherRunning)
+        return;
+    StopBackend();
+    watcherRunning = false;
+
+    std::lock_guard<std::mutex> lock(watchMutex);
+    watches.clear();
+    diskWatches.clear();
+    pendingWatches.clear();
+    readyWatches.clear();
+}
+
+// ---------------- Watches ----------------
+
+i32 WatchAssets(const array<std::string> &paths, WatchCallback callback)
+{
+    if (!watcherRunning)
+        return -1;
+
+    AssetWatch watch;
+    watch.paths = paths;
+    watch.callback = std::move(callback);
+    for (const std::string &path : paths)
+    {
+        for (std::string &diskPath : VfsDiskPaths(VfsPath(path.c_str())))
+            watch.diskPaths.push_back(std::move(diskPath));
+    }
+
+    std::lock_guard<std::mutex> lock(watchMutex);
+    i32 id = nextWatchId++;
+    for (const std::string &diskPath : watch.diskPaths)
+    {
+        WatchDiskPath(diskPath);
+        diskWatches[diskPath].push_back(id);
+    }
+    watches.emplace(id, std::move(watch));
+    return id;
+}
+
+i32 WatchAsset(VfsPath path, WatchCallback callback)
+{
+    return WatchAssets({path.path}, std::move(callback));
+}
+
+void UnwatchAsset(i32 watchId)
+{
+    std::lock_guard<std::mutex> lock(watchMutex);
+    auto it = watches.find(watchId);
+    if (it == watches.end())
+        return;
+
+    for (const std::string &diskPath : it->second.diskPaths)
+    {
+        auto disk = diskWatches.find(diskPath);
+        if (disk == diskWatches.end())
+            continue;
+        std::erase(disk->second, watchId);
+        if (disk->second.empty())
+            diskWatches.erase(disk);
+        UnwatchDiskPath(diskPath);
+    }
+    pendingWatches.erase(watchId);
+    std::erase(readyWatches, watchId);
+    watches.erase(it);
+}
+
+void UpdateFileWatcher()
+{
+    // Per-frame copies live in the frame arena
+    frame_array<i32> ready;
+    {
+        std::lock_guard<std::mutex> lock(watchMutex);
+        if (readyWatches.empty())
+            return;
+        ready.assign(readyWatches.begin(), readyWatches.end());
+        readyWatches.clear();
+    }
+
+    for (i32 id : ready)
+    {
+        // Copied out: a callback may add or remove watches, including its own
+        WatchCallback callback;
+        frame_array<frame_string> paths;
+        {
+            std::lock_guard<std::mutex> lock(watchMutex);
+            auto it = watches.find(id);
+            if (it == watches.end())
+                continue;
+            callback = it->second.callback;
+            paths.reserve(it->second.paths.size());
+            for (const std::string &path : it->second.paths)
+                paths.emplace_back(path.data(), path.size());
+        }
+
+        // A changed file may also have appeared in or vanished from a mount
+        for (const frame_string &path : paths)
+            VfsInvalidate(VfsPath(path.c_str()));
+
+        print("Reloading %s", paths.empty() ? "" : paths[0].c_str());
+        callback();
+    }
+}
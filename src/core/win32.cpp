@@ -14,14 +14,19 @@ HGLRC modernContext = nullptr;
 LARGE_INTEGER frequency;
 LARGE_INTEGER lastCounter;
 
-BumpAllocator persistentStorage;
-Input input = nullptr;
-
 const char* CLASS_NAME = "AtlasEngineClass";
 
 PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB = nullptr;
+PFNWGLSWAPINTERVALEXTPROC wglSwapIntervalEXT = nullptr;
+bool swapControlTear = false; // WGL_EXT_swap_control_tear: negative intervals allowed
 
 // ---------------- Window Procedure ----------------
+// Tick count of the message being handled, in seconds
+static double MessageTime()
+{
+    return (u32)GetMessageTime() / 1000.0;
+}
+
 LRESULT CALLBACK WndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
     switch (uMsg)
@@ -43,40 +48,48 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 
         case WM_CHAR:
         {
-            unsigned int ch = (unsigned int)wParam;
-            if (ch >= 32 || ch == '\n' || ch == '\t')
+            // UTF-16: characters outside the BMP arrive as two messages
+            static c32 highSurrogate = 0;
+            c32 ch = (c32)wParam;
+            if (ch >= 0xD800 && ch < 0xDC00)
             {
-                input->typedChar = (char)ch;
-                input->charTyped = true;
+                highSurrogate = ch;
+                return 0;
             }
+            if (ch >= 0xDC00 && ch < 0xE000)
+            {
+                if (!highSurrogate)
+                    return 0;
+                ch = 0x10000 + ((highSurrogate - 0xD800) << 10) + (ch - 0xDC00);
+            }
+            highSurrogate = 0;
+
+            if (ch >= 32 || ch == '\r' || ch == '\t')
+                RecordChar(ch, MessageTime());
             return 0;
         }
 
         case WM_KEYDOWN:
-            if (!(lParam & 0x40000000)) // first press
-                input->keyPressed[wParam] = true;
-            input->keyDown[wParam] = true;
+            RecordKey((u8)wParam, true, MessageTime());
             return 0;
 
         case WM_KEYUP:
-            input->keyDown[wParam] = false;
-            input->keyReleased[wParam] = true;
+            RecordKey((u8)wParam, false, MessageTime());
             return 0;
 
-        case WM_LBUTTONDOWN: input->mousePressed[0] = input->mouseDown[0] = true; return 0;
-        case WM_LBUTTONUP:   input->mouseDown[0] = false; input->mouseReleased[0] = true; return 0;
-        case WM_RBUTTONDOWN: input->mousePressed[1] = input->mouseDown[1] = true; return 0;
-        case WM_RBUTTONUP:   input->mouseDown[1] = false; input->mouseReleased[1] = true; return 0;
-        case WM_MBUTTONDOWN: input->mousePressed[2] = input->mouseDown[2] = true; return 0;
-        case WM_MBUTTONUP:   input->mouseDown[2] = false; input->mouseReleased[2] = true; return 0;
+        case WM_LBUTTONDOWN: RecordMouseButton(MOUSE_LEFT, true, MessageTime()); return 0;
+        case WM_LBUTTONUP:   RecordMouseButton(MOUSE_LEFT, false, MessageTime()); return 0;
+        case WM_RBUTTONDOWN: RecordMouseButton(MOUSE_RIGHT, true, MessageTime()); return 0;
+        case WM_RBUTTONUP:   RecordMouseButton(MOUSE_RIGHT, false, MessageTime()); return 0;
+        case WM_MBUTTONDOWN: RecordMouseButton(MOUSE_MIDDLE, true, MessageTime()); return 0;
+        case WM_MBUTTONUP:   RecordMouseButton(MOUSE_MIDDLE, false, MessageTime()); return 0;
 
         case WM_MOUSEMOVE:
-            input->mouseX = GET_X_LPARAM(lParam);
-            input->mouseY = GET_Y_LPARAM(lParam);
+            RecordMouseMove(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam), MessageTime());
             return 0;
 
         case WM_MOUSEWHEEL:
-            input->scrollY = GET_WHEEL_DELTA_WPARAM(wParam) / WHEEL_DELTA;
+            RecordScroll(GET_WHEEL_DELTA_WPARAM(wParam) / WHEEL_DELTA, MessageTime());
             return 0;
 
         default:
@@ -90,13 +103,15 @@ bool InitPlatform()
     QueryPerformanceFrequency(&frequency);
     QueryPerformanceCounter(&lastCounter);
 
-    persistentStorage = MakeAllocator(MB(100));
-    input = BumpAlloc<Input_>(&persistentStorage);
+    // 1 ms scheduler granularity instead of 15.6, so frame pacing can sleep
+    timeBeginPeriod(1);
+
+    InitEngineServices();
     return true;
 }
 
 // ---------------- Create Window & OpenGL Context ----------------
-Window CreateWindowPlatform(const str& name, const i32& width, const i32& height)
+bool CreateWindowPlatform(str name, i32 width, i32 height)
 {
     input->screen = ivec2(width, height);
     HINSTANCE hInstance = GetModuleHandleA(NULL);
@@ -118,7 +133,7 @@ Window CreateWindowPlatform(const str& name, const i32& width, const i32& height
         rect.right - rect.left, rect.bottom - rect.top,
         nullptr, nullptr, hInstance, nullptr);
 
-    if (!window) return nullptr;
+    if (!window) return false;
 
     hdc = GetDC(window);
 
@@ -142,14 +157,14 @@ Window CreateWindowPlatform(const str& name, const i32& width, const i32& height
     if (!gladLoadGL())
     {
         MessageBoxA(0, "Failed to initialize GLAD!", "Error", MB_OK | MB_ICONERROR);
-        return nullptr;
+        return false;
     }
 
     wglCreateContextAttribsARB = (PFNWGLCREATECONTEXTATTRIBSARBPROC)wglGetProcAddress("wglCreateContextAttribsARB");
     if (!wglCreateContextAttribsARB)
     {
         MessageBoxA(0, "wglCreateContextAttribsARB not supported!", "Error", MB_OK | MB_ICONERROR);
-        return nullptr;
+        return false;
     }
 
     int attribs[] = {
@@ -164,7 +179,7 @@ Window CreateWindowPlatform(const str& name, const i32& width, const i32& height
     if (!modernContext)
     {
         MessageBoxA(0, "Failed to create modern OpenGL context!", "Error", MB_OK | MB_ICONERROR);
-        return nullptr;
+        return false;
     }
 
     // Switch contexts
@@ -178,6 +193,14 @@ Window CreateWindowPlatform(const str& name, const i32& width, const i32& height
     glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
     glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
 
+    wglSwapIntervalEXT = (PFNWGLSWAPINTERVALEXTPROC)wglGetProcAddress("wglSwapIntervalEXT");
+    auto wglGetExtensionsStringEXT = (PFNWGLGETEXTENSIONSSTRINGEXTPROC)wglGetProcAddress("wglGetExtensionsStringEXT");
+    if (wglGetExtensionsStringEXT)
+    {
+        str extensions = wglGetExtensionsStringEXT();
+        swapControlTear = HasExtension(extensions, "WGL_EXT_swap_control_tear");
+    }
+
     ShowWindow(window, SW_SHOW);
 
     // Safe: Windows 10+ only
@@ -188,7 +211,7 @@ Window CreateWindowPlatform(const str& name, const i32& width, const i32& height
     glViewport(0, 0, rc.right - rc.left, rc.bottom - rc.top);
 
     running = true;
-    return window;
+    return true;
 }
 
 // ---------------- Event Handling ----------------
@@ -199,29 +222,53 @@ void PollEvent(Event* event)
     event->deltaTime = (float)(now.QuadPart - lastCounter.QuadPart) / frequency.QuadPart;
     lastCounter = now;
 
-    for (int i = 0; i < 256; i++) { input->keyPressed[i] = input->keyReleased[i] = false; }
-    input->charTyped = false;
-    for (int i = 0; i < 5; i++) { input->mousePressed[i] = input->mouseReleased[i] = false; }
-    input->scrollY = 0;
-
-    input->prevMouseX = input->mouseX;
-    input->prevMouseY = input->mouseY;
+    BeginInputFrame();
 
+    event->activity = false;
     MSG msg;
     while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
     {
+        event->activity = true;
         if (msg.message == WM_QUIT)
             running = false;
         TranslateMessage(&msg);
         DispatchMessage(&msg);
-        event->msg = msg;
     }
+
+    // No raw input here yet; raw motion is the cursor's
+    input->rawMouseDelta = vec2((float)(input->mouseX - input->prevMouseX), (float)(input->mouseY - input->prevMouseY));
+}
+
+void WaitForEvents(double timeoutSeconds)
+{
+    // MWMO_INPUTAVAILABLE: also wake for messages already queued but not yet read
+    MsgWaitForMultipleObjectsEx(0, nullptr, (DWORD)(timeoutSeconds * 1000.0), QS_ALLINPUT, MWMO_INPUTAVAILABLE);
 }
 
 bool ShouldClose() { return !running; }
 
+bool IsHeadless() { return false; }
+
 void SwapBuffersWindow() { SwapBuffers(hdc); }
 
+bool SetSwapInterval(i32 interval)
+{
+    if (!wglSwapIntervalEXT)
+        return false;
+    if (interval < 0 && !swapControlTear)
+        interval = -interval;
+    return wglSwapIntervalEXT(interval) == TRUE;
+}
+
+void *GetGLProcAddress(str name)
+{
+    // wglGetProcAddress only knows extensions and post-1.1 entry points
+    void *proc = (void *)wglGetProcAddress(name);
+    if (!proc || proc == (void *)1 || proc == (void *)2 || proc == (void *)3 || proc == (void *)-1)
+        proc = (void *)GetProcAddress(GetModuleHandleA("opengl32.dll"), name);
+    return proc;
+}
+
 void DestroyPlatform()
 {
     running = false;
@@ -237,6 +284,9 @@ void DestroyPlatform()
     if (window) { DestroyWindow(window); window = nullptr; }
 
     UnregisterClassA(CLASS_NAME, GetModuleHandleA(NULL));
+    timeEndPeriod(1);
+
+    ShutdownEngineServices();
 }
 
 void SetTitleBarColor(COLORREF textColor, COLORREF backgroundColor)
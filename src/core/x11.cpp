@@ -0,0 +1,512 @@
+#include <platform/platform.h>
+#include <engine/input.h>
+#include <glad/glad.h>
+#include <poll.h>
+#include <time.h>
+
+// Xlib typedefs its own KeyCode (a raw keycode byte); rename it so the
+// engine's KeyCode enum keeps the name in this file
+#define KeyCode XKeyCode
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/XKBlib.h>
+#include <X11/keysym.h>
+#include <GL/glx.h>
+#ifdef ATLAS_XINPUT2
+#include <X11/extensions/XInput2.h>
+#endif
+#undef KeyCode
+
+bool running = false;
+
+static Display *display = nullptr;
+static Window window = 0;
+static Colormap colormap = 0;
+static GLXContext context = nullptr;
+static Atom wmDeleteWindow = 0;
+static XIM inputMethod = nullptr;
+static XIC inputContext = nullptr;
+static bool focused = true;
+static bool activity = false; // any event handled this poll
+static i32 xiOpcode = -1; // XInput2 major opcode, -1 without raw input
+
+static u8 keyTable[256]; // X keycode -> KeyCode, 0 for keys the engine doesn't name
+
+static timespec lastCounter;
+
+// ---------------- Keyboard ----------------
+static u8 TranslateKeysym(KeySym sym)
+{
+    if (sym >= XK_a && sym <= XK_z) return (u8)(KEY_A + (sym - XK_a));
+    if (sym >= XK_0 && sym <= XK_9) return (u8)(KEY_0 + (sym - XK_0));
+    if (sym >= XK_F1 && sym <= XK_F12) return (u8)(KEY_F1 + (sym - XK_F1));
+
+    switch (sym)
+    {
+        case XK_Up:        return KEY_UP;
+        case XK_Down:      return KEY_DOWN;
+        case XK_Left:      return KEY_LEFT;
+        case XK_Right:     return KEY_RIGHT;
+        case XK_Shift_L:
+        case XK_Shift_R:   return KEY_SHIFT;
+        case XK_Control_L:
+        case XK_Control_R: return KEY_CTRL;
+        case XK_Alt_L:
+        case XK_Alt_R:     return KEY_ALT;
+        case XK_space:     return KEY_SPACE;
+        case XK_Tab:       return KEY_TAB;
+        case XK_Caps_Lock: return KEY_CAPSLOCK;
+        case XK_Return:
+        case XK_KP_Enter:  return KEY_ENTER;
+        case XK_BackSpace: return KEY_BACKSPACE;
+        case XK_Escape:    return KEY_ESCAPE;
+        case XK_Insert:    return KEY_INSERT;
+        case XK_Delete:    return KEY_DELETE;
+        case XK_Home:      return KEY_HOME;
+        case XK_End:       return KEY_END;
+        case XK_Prior:     return KEY_PAGEUP;
+        case XK_Next:      return KEY_PAGEDOWN;
+        default:           return 0;
+    }
+}
+
+// Keyed by the unshifted keysym of each physical key, like virtual-key codes
+static void BuildKeyTable()
+{
+    i32 minKeycode = 0, maxKeycode = 0;
+    XDisplayKeycodes(display, &minKeycode, &maxKeycode);
+    for (i32 code = minKeycode; code <= maxKeycode && code < 256; code++)
+        keyTable[code] = TranslateKeysym(XkbKeycodeToKeysym(display, (XKeyCode)code, 0, 0));
+}
+
+// One character; *size is the bytes it took
+static c32 DecodeUtf8(const char *text, i32 length, i32 *size)
+{
+    u8 lead = (u8)text[0];
+    i32 count = lead < 0x80 ? 0 : lead < 0xE0 ? 1 : lead < 0xF0 ? 2 : 3;
+    *size = count + 1;
+    if (count >= length)
+        return 0;
+
+    c32 ch = count == 0 ? lead : lead & (0x3F >> count);
+    for (i32 i = 1; i <= count; i++)
+        ch = (ch << 6) | ((u8)text[i] & 0x3F);
+    return ch;
+}
+
+// X server timestamps count milliseconds
+static double EventTime(Time time)
+{
+    return time / 1000.0;
+}
+
+static void TypeChar(XKeyEvent *key)
+{
+    char text[32];
+    KeySym sym = 0;
+    i32 length;
+    if (inputContext)
+    {
+        Status status;
+        length = Xutf8LookupString(inputContext, key, text, sizeof(text) - 1, &sym, &status);
+        if (status != XLookupChars && status != XLookupBoth)
+            return;
+    }
+    else
+        length = XLookupString(key, text, sizeof(text) - 1, &sym, nullptr);
+
+    if (length <= 0)
+        return;
+
+    // An input method may commit several characters at once
+    for (i32 at = 0; at < length;)
+    {
+        i32 size;
+        c32 ch = DecodeUtf8(text + at, length - at, &size);
+        at += size;
+        if ((ch >= 32 && ch != 127) || ch == '\r' || ch == '\t')
+            RecordChar(ch, EventTime(key->time));
+    }
+}
+
+// Input method for composed / dead-key text; plain XLookupString without one
+static void InitTextInput()
+{
+    XSetLocaleModifiers("");
+    inputMethod = XOpenIM(display, nullptr, nullptr, nullptr);
+    if (!inputMethod)
+        return;
+
+    inputContext = XCreateIC(inputMethod,
+        XNInputStyle, XIMPreeditNothing | XIMStatusNothing,
+        XNClientWindow, window,
+        XNFocusWindow, window,
+        nullptr);
+    if (inputContext)
+        XSetICFocus(inputContext);
+}
+
+// ---------------- Raw mouse ----------------
+#ifdef ATLAS_XINPUT2
+// XI_RawMotion carries device deltas before pointer acceleration, and keeps
+// coming when the cursor is pinned at a screen edge
+static void InitRawInput()
+{
+    i32 firstEvent, firstError;
+    if (!XQueryExtension(display, "XInputExtension", &xiOpcode, &firstEvent, &firstError))
+    {
+        xiOpcode = -1;
+        return;
+    }
+
+    i32 major = 2, minor = 0;
+    if (XIQueryVersion(display, &major, &minor) != Success)
+    {
+        xiOpcode = -1;
+        return;
+    }
+
+    // Raw events are only delivered to the root window
+    u8 mask[XIMaskLen(XI_RawMotion)] = {};
+    XISetMask(mask, XI_RawMotion);
+    XIEventMask eventMask = {XIAllMasterDevices, (i32)sizeof(mask), mask};
+    XISelectEvents(display, DefaultRootWindow(display), &eventMask, 1);
+}
+
+static void HandleRawMotion(const XIRawEvent *raw)
+{
+    // raw_values holds one value per set valuator bit, in bit order
+    const double *value = raw->raw_values;
+    for (i32 axis = 0; axis < raw->valuators.mask_len * 8 && axis < 2; axis++)
+    {
+        if (!XIMaskIsSet(raw->valuators.mask, axis))
+            continue;
+        if (focused)
+            (axis == 0 ? input->rawMouseDelta.x : input->rawMouseDelta.y) += (float)*value;
+        value++;
+    }
+}
+#endif
+
+// ---------------- Vsync ----------------
+bool SetSwapInterval(i32 interval)
+{
+    if (!display || !window)
+        return false;
+    str extensions = glXQueryExtensionsString(display, DefaultScreen(display));
+
+    auto swapIntervalEXT = (PFNGLXSWAPINTERVALEXTPROC)glXGetProcAddressARB((const GLubyte *)"glXSwapIntervalEXT");
+    if (swapIntervalEXT && HasExtension(extensions, "GLX_EXT_swap_control"))
+    {
+        if (interval < 0 && !HasExtension(extensions, "GLX_EXT_swap_control_tear"))
+            interval = -interval;
+        swapIntervalEXT(display, window, interval);
+        return true;
+    }
+
+    // No adaptive mode here
+    auto swapIntervalMESA = (PFNGLXSWAPINTERVALMESAPROC)glXGetProcAddressARB((const GLubyte *)"glXSwapIntervalMESA");
+    if (swapIntervalMESA && HasExtension(extensions, "GLX_MESA_swap_control"))
+        return swapIntervalMESA(interval < 0 ? -interval : interval) == 0;
+    return false;
+}
+
+// ---------------- Platform Init ----------------
+bool InitPlatform()
+{
+    clock_gettime(CLOCK_MONOTONIC, &lastCounter);
+
+    InitEngineServices();
+    return true;
+}
+
+// ---------------- Create Window & OpenGL Context ----------------
+// A context version the driver doesn't support is reported as an X error,
+// whose default handler exits the process
+static bool contextFailed = false;
+static int IgnoreContextError(Display *, XErrorEvent *)
+{
+    contextFailed = true;
+    return 0;
+}
+
+bool CreateWindowPlatform(str name, i32 width, i32 height)
+{
+    input->screen = ivec2(width, height);
+
+    display = XOpenDisplay(nullptr);
+    if (!display)
+    {
+        print("Failed to open X display");
+        return false;
+    }
+
+    static const int visualAttribs[] = {
+        GLX_X_RENDERABLE, True,
+        GLX_DRAWABLE_TYPE, GLX_WINDOW_BIT,
+        GLX_RENDER_TYPE, GLX_RGBA_BIT,
+        GLX_X_VISUAL_TYPE, GLX_TRUE_COLOR,
+        GLX_RED_SIZE, 8,
+        GLX_GREEN_SIZE, 8,
+        GLX_BLUE_SIZE, 8,
+        GLX_ALPHA_SIZE, 8,
+        GLX_DEPTH_SIZE, 24,
+        GLX_STENCIL_SIZE, 8,
+        GLX_DOUBLEBUFFER, True,
+        None
+    };
+
+    i32 configCount = 0;
+    GLXFBConfig *configs = glXChooseFBConfig(display, DefaultScreen(display), visualAttribs, &configCount);
+    if (!configs || configCount == 0)
+    {
+        print("No matching GLX framebuffer config");
+        return false;
+    }
+    GLXFBConfig config = configs[0];
+    XFree(configs);
+
+    XVisualInfo *visual = glXGetVisualFromFBConfig(display, config);
+    if (!visual)
+    {
+        print("No X visual for the GLX framebuffer config");
+        return false;
+    }
+
+    Window root = RootWindow(display, visual->screen);
+    colormap = XCreateColormap(display, root, visual->visual, AllocNone);
+
+    XSetWindowAttributes attributes = {};
+    attributes.colormap = colormap;
+    attributes.event_mask = KeyPressMask | KeyReleaseMask | ButtonPressMask | ButtonReleaseMask |
+                            PointerMotionMask | StructureNotifyMask | FocusChangeMask | ExposureMask;
+
+    window = XCreateWindow(display, root, 0, 0, width, height, 0, visual->depth, InputOutput,
+                           visual->visual, CWColormap | CWEventMask, &attributes);
+    XFree(visual);
+    if (!window) return false;
+
+    XStoreName(display, window, name);
+    wmDeleteWindow = XInternAtom(display, "WM_DELETE_WINDOW", False);
+    XSetWMProtocols(display, window, &wmDeleteWindow, 1);
+
+    auto glXCreateContextAttribsARB = (PFNGLXCREATECONTEXTATTRIBSARBPROC)glXGetProcAddressARB((const GLubyte *)"glXCreateContextAttribsARB");
+    if (!glXCreateContextAttribsARB)
+    {
+        print("glXCreateContextAttribsARB not supported!");
+        return false;
+    }
+
+    // 4.6 like the Win32 backend; Mesa drivers may stop at 4.5
+    auto previousHandler = XSetErrorHandler(IgnoreContextError);
+    for (i32 minor : {6, 5})
+    {
+        int attribs[] = {
+            GLX_CONTEXT_MAJOR_VERSION_ARB, 4,
+            GLX_CONTEXT_MINOR_VERSION_ARB, minor,
+            GLX_CONTEXT_PROFILE_MASK_ARB, GLX_CONTEXT_CORE_PROFILE_BIT_ARB,
+            GLX_CONTEXT_FLAGS_ARB, GLX_CONTEXT_DEBUG_BIT_ARB,
+            None
+        };
+
+        contextFailed = false;
+        context = glXCreateContextAttribsARB(display, config, nullptr, True, attribs);
+        XSync(display, False);
+        if (context && !contextFailed)
+            break;
+        if (context)
+            glXDestroyContext(display, context); // created, but with an error
+        context = nullptr;
+    }
+    XSetErrorHandler(previousHandler);
+
+    if (!context)
+    {
+        print("Failed to create modern OpenGL context!");
+        return false;
+    }
+
+    glXMakeCurrent(display, window, context);
+
+    if (!gladLoadGL())
+    {
+        print("Failed to initialize GLAD!");
+        return false;
+    }
+
+    glEnable(GL_DEBUG_OUTPUT);
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+
+    // Adaptive vsync where available: a late frame swaps immediately and
+    // tears instead of waiting a whole extra refresh
+    SetSwapInterval(-1);
+
+    // Held keys repeat as KeyPress only, without a fake KeyRelease in between
+    XkbSetDetectableAutoRepeat(display, True, nullptr);
+    BuildKeyTable();
+    InitTextInput();
+#ifdef ATLAS_XINPUT2
+    InitRawInput();
+#endif
+
+    XMapWindow(display, window);
+    glViewport(0, 0, width, height);
+
+    running = true;
+    return true;
+}
+
+// ---------------- Event Handling ----------------
+static void HandleEvent(XEvent *event)
+{
+    // Raw motion arrives wherever the pointer is; only count it when focused
+    if (event->type != GenericEvent || focused)
+        activity = true;
+
+    switch (event->type)
+    {
+        case ClientMessage:
+            if ((Atom)event->xclient.data.l[0] == wmDeleteWindow)
+                running = false;
+            return;
+
+        case ConfigureNotify:
+        {
+            ivec2 size(event->xconfigure.width, event->xconfigure.height);
+            if (size.x != input->screen.x || size.y != input->screen.y)
+            {
+                input->screen = size;
+                glViewport(0, 0, size.x, size.y);
+            }
+            return;
+        }
+
+        case FocusIn:  focused = true;  return;
+        case FocusOut: focused = false; return;
+
+        case KeyPress:
+        {
+            u8 key = keyTable[event->xkey.keycode];
+            if (key)
+                RecordKey(key, true, EventTime(event->xkey.time));
+            TypeChar(&event->xkey);
+            return;
+        }
+
+        case KeyRelease:
+        {
+            u8 key = keyTable[event->xkey.keycode];
+            if (key)
+                RecordKey(key, false, EventTime(event->xkey.time));
+            return;
+        }
+
+        case ButtonPress:
+        case ButtonRelease:
+        {
+            bool down = event->type == ButtonPress;
+            double time = EventTime(event->xbutton.time);
+            i32 button;
+            switch (event->xbutton.button)
+            {
+                case Button1: button = MOUSE_LEFT; break;
+                case Button2: button = MOUSE_MIDDLE; break;
+                case Button3: button = MOUSE_RIGHT; break;
+                case Button4: if (down) RecordScroll(1, time); return;  // wheel up
+                case Button5: if (down) RecordScroll(-1, time); return; // wheel down
+                case 8:       button = MOUSE_X1; break;
+                case 9:       button = MOUSE_X2; break;
+                default:      return;
+            }
+            RecordMouseButton(button, down, time);
+            return;
+        }
+
+        case MotionNotify:
+            RecordMouseMove(event->xmotion.x, event->xmotion.y, EventTime(event->xmotion.time));
+            return;
+
+#ifdef ATLAS_XINPUT2
+        case GenericEvent:
+            if (event->xcookie.extension == xiOpcode && XGetEventData(display, &event->xcookie))
+            {
+                if (event->xcookie.evtype == XI_RawMotion)
+                    HandleRawMotion((const XIRawEvent *)event->xcookie.data);
+                XFreeEventData(display, &event->xcookie);
+            }
+            return;
+#endif
+    }
+}
+
+void PollEvent(Event* event)
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    event->deltaTime = (float)(now.tv_sec - lastCounter.tv_sec) + (float)(now.tv_nsec - lastCounter.tv_nsec) * 1e-9f;
+    lastCounter = now;
+
+    BeginInputFrame();
+    activity = false;
+
+    // XPending flushes and reads the connection once; what it queued drains
+    // without further round trips, and QueuedAlready only counts what's local
+    for (i32 count = XPending(display); count > 0; count = XEventsQueued(display, QueuedAlready))
+    {
+        while (count-- > 0)
+        {
+            XEvent xevent;
+            XNextEvent(display, &xevent);
+            if (XFilterEvent(&xevent, None)) // consumed by the input method
+                continue;
+            HandleEvent(&xevent);
+        }
+    }
+
+    if (xiOpcode < 0)
+        input->rawMouseDelta = vec2((float)(input->mouseX - input->prevMouseX), (float)(input->mouseY - input->prevMouseY));
+    event->activity = activity;
+}
+
+void WaitForEvents(double timeoutSeconds)
+{
+    if (XPending(display))
+        return;
+    pollfd connection = {ConnectionNumber(display), POLLIN, 0};
+    poll(&connection, 1, (int)(timeoutSeconds * 1000.0));
+}
+
+bool ShouldClose() { return !running; }
+
+bool IsHeadless() { return false; }
+
+void SwapBuffersWindow() { glXSwapBuffers(display, window); }
+
+void *GetGLProcAddress(str name)
+{
+    return (void *)glXGetProcAddressARB((const GLubyte *)name);
+}
+
+void DestroyPlatform()
+{
+    running = false;
+
+    if (display)
+    {
+        if (context)
+        {
+            glXMakeCurrent(display, None, nullptr);
+            glXDestroyContext(display, context);
+            context = nullptr;
+        }
+        if (inputContext) { XDestroyIC(inputContext); inputContext = nullptr; }
+        if (inputMethod) { XCloseIM(inputMethod); inputMethod = nullptr; }
+        if (window) { XDestroyWindow(display, window); window = 0; }
+        if (colormap) { XFreeColormap(display, colormap); colormap = 0; }
+        XCloseDisplay(display);
+        display = nullptr;
+    }
+
+    ShutdownEngineServices();
+}
@@ -1,240 +1,77 @@
 #include <glad/glad.h>
-#include <platform/win32.h>
+#include <platform/platform.h>
 #include <engine/input.h>
 #include <engine/shader.h>
-
+#include <engine/render.h>
+#include <engine/text.h>
+#include <engine/memory.h>
+#include <engine/debug.h>
+#include <engine/texture.h>
+#include <engine/watch.h>
+#include <engine/timestep.h>
+#include <engine/pacing.h>
+#include <engine/uniforms.h>
+
+// Decoded images are accounted to the assets tag
+#define STBI_MALLOC(size) TrackedMalloc(MEM_ASSETS, size)
+#define STBI_REALLOC(ptr, size) TrackedRealloc(MEM_ASSETS, ptr, size)
+#define STBI_FREE(ptr) TrackedFree(ptr)
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
 
-#include <ft2build.h>
-#include FT_FREETYPE_H
-
-#include <map>
-#include <algorithm>
-
-struct Vertex
-{
-    vec2 pos;
-    vec2 uv;
-    vec4 color;
-};
-struct Glyph
-{
-    ivec2 size;
-    ivec2 bearing;
-    u32 advance;
-    ivec2 atlasPos;
-};
-struct Batch
-{
-    u32 vao{}, vbo{}, ebo{};
-    u32 tex{0};
-    i32 w{}, h{}, chs{};
-    array<Vertex> vertices;
-    array<u32> indices;
-
-    void reserve(size_t quadCount)
-    {
-        vertices.reserve(quadCount * 4); // 4 vertices per quad
-        indices.reserve(quadCount * 6);  // 6 indices per quad
-    }
-};
-
-std::map<char, Glyph> glyphs;
-bool LoadFont(int width, str filepath = "assets/fonts/arial.ttf")
+int main()
 {
-    FT_Library ft;
-    if (FT_Init_FreeType(&ft))
-    {
-        printf("Failed to init FreeType\n");
-        return false;
-    }
-
-    FT_Face face;
-    if (FT_New_Face(ft, filepath, 0, &face))
+    InitPlatform();
+    bool created;
     {
-        printf("Failed to load font\n");
-        return false;
+        // Loading the GL driver allocates state it keeps until exit
+        MemoryTagScope driverMemory(MEM_EXTERNAL);
+        created = CreateWindowPlatform("atlas - engine", 956, 540);
     }
-
-    FT_Set_Pixel_Sizes(face, 0, 48); // height = 48px
-
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    int x = 0;
-    int y = 0;
-    int rowHeight = 0;
-    int padding = 2;
-
-    for (unsigned char c = 32; c < 128; c++)
+    if (!created)
     {
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER))
-            continue;
-
-        if (x + face->glyph->bitmap.width + padding >= width)
-        {
-            x = 0;
-            y += rowHeight;
-            rowHeight = 0;
-        }
-
-        glTexSubImage2D(
-            GL_TEXTURE_2D,
-            0,
-            x,
-            y,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            GL_RED,
-            GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer);
-
-        Glyph g;
-        g.size = ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows);
-        g.bearing = ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top);
-        g.advance = face->glyph->advance.x;
-        g.atlasPos = ivec2(x, y);
-
-        glyphs.insert({c, g});
-
-        rowHeight = std::max(rowHeight,
-                             static_cast<int>(face->glyph->bitmap.rows) + padding);
-        x += face->glyph->bitmap.width + padding;
-    }
-
-    return true;
-}
-
-array<Batch> batches;
-
-void DrawQuad(Batch &b, vec2 pos, vec2 size, ivec2 ioffset, ivec2 isize, vec4 color = vec4(1.0f), bool flipX = false, bool flipY = false)
-{
-    u32 startIndex = b.vertices.size();
-
-    // 1. Calculate atlas pixel coordinates
-    float x0 = float(ioffset.x);
-    float y0 = float(ioffset.y);
-    float x1 = float(ioffset.x + isize.x);
-    float y1 = float(ioffset.y + isize.y);
-
-    // Handle flipping (useful for sprites, usually false for text)
-    if (flipX)
-        std::swap(x0, x1);
-    if (flipY)
-        std::swap(y0, y1);
-
-    // Normalize UVs (0 to 1 range)
-    float w = float(b.w);
-    float h = float(b.h);
-
-    vec2 uvTL = vec2(x0 / w, y0 / h);
-    vec2 uvTR = vec2(x1 / w, y0 / h);
-    vec2 uvBR = vec2(x1 / w, y1 / h);
-    vec2 uvBL = vec2(x0 / w, y1 / h);
-
-    // 2. Push vertices (Counter-Clockwise order)
-    // Using your Ortho: (0,0) is bottom-left, (screen.x, screen.y) is top-right
-    b.vertices.push_back(Vertex{.pos = vec2(pos.x, pos.y), .uv = uvBL, .color = color});                   // Bottom-Left
-    b.vertices.push_back(Vertex{.pos = vec2(pos.x + size.x, pos.y), .uv = uvBR, .color = color});          // Bottom-Right
-    b.vertices.push_back(Vertex{.pos = vec2(pos.x + size.x, pos.y + size.y), .uv = uvTR, .color = color}); // Top-Right
-    b.vertices.push_back(Vertex{.pos = vec2(pos.x, pos.y + size.y), .uv = uvTL, .color = color});          // Top-Left
-
-    // 3. Push indices
-    b.indices.push_back(startIndex + 0);
-    b.indices.push_back(startIndex + 1);
-    b.indices.push_back(startIndex + 2);
-    b.indices.push_back(startIndex + 2);
-    b.indices.push_back(startIndex + 3);
-    b.indices.push_back(startIndex + 0);
-};
-
-void DrawRect(vec2 pos, vec2 size, ivec2 ioffset, ivec2 isize, vec4 color = vec4(1.0f), bool flipX = false, bool flipY = false)
-{
-    DrawQuad(
-        batches[0], pos,
-        size, ioffset,
-        isize, color,
-        flipX, flipY);
-}
-
-void DrawCircle(vec2 pos, float radius, int segment = 8, vec4 color = vec4(1.0f))
-{
-    array<Vertex>& vertices = batches[0].vertices;
-    array<u32>& indices = batches[0].indices;
-    u32 startIndex = vertices.size();
-
-    // Center vertex
-    vertices.push_back(
-        Vertex{
-            .pos = pos,
-            .uv = vec2(0.0f),
-            .color = color
-        }
-    ); 
-    
-    // Outer circle vertices
-    for(int i = 0; i < segment; i++) {
-        float theta = 2.0f * 3.1415926f * float(i) / float(segment);
-        float x = radius * cosf(theta);
-        float y = radius * sinf(theta);
-        
-        vertices.push_back(
-            Vertex{
-                .pos = pos + vec2(x, y),   // important: offset by center
-                .uv = vec2(0.0f),
-                .color = color
-            }
-        ); 
+        DestroyPlatform();
+        return 1;
     }
-    
-    // Indices (triangle fan)
-    for(int i = 0; i < segment; i++) {
-        u32 current = startIndex + 1 + i;
-        u32 next    = startIndex + 1 + ((i + 1) % segment);
-
-        indices.push_back(startIndex);  // center
-        indices.push_back(current);
-        indices.push_back(next);
-    }
-}
-
-void RenderText(std::string text, float x, float y, float scale, vec4 color)
-{
-    for (char c : text)
-    {
-        Glyph g = glyphs[c];
-
-        float xpos = x + g.bearing.x * scale;
-        float ypos = y - (g.size.y - g.bearing.y) * scale;
-
-        float w = g.size.x * scale;
-        float h = g.size.y * scale;
 
-        DrawQuad(
-            batches[1],
-            vec2(xpos, ypos),
-            vec2(w, h),
-            g.atlasPos,
-            g.size,
-            color);
+    // Optional mounts over the loose files: cooked textures (cook_textures
+    // target) and assets.pak (pack_assets target), if present. Both targets
+    // write to the source directory, the working directory the app expects.
+    VfsMountDirectory("cooked", 5);
+    VfsMountPack("assets.pak");
 
-        x += (g.advance >> 6) * scale;
-    }
-}
+    // Adaptive vsync paces frames when the backend can set it; otherwise the
+    // pacer caps at 60 fps. A static screen renders only when something changes.
+    FramePacer pacer;
+    InitFramePacer(&pacer, SetSwapInterval(-1) ? 0 : 60, true);
 
-int main()
-{
-    InitPlatform();
-    CreateWindowPlatform("atlas - engine", 956, 540);
+    // Edited shaders, textures and fonts are reloaded between frames
+    InitFileWatcher();
 
     glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    u32 program = CreateShaderProgram(
-        "assets/shaders/scene.vert",
-        "assets/shaders/scene.frag");
-
-    glUseProgram(program);
-    SetUniform(program, "atlasTexture", 0);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); // premultiplied alpha
+
+    // Shared by every program through the FrameConstants block
+    InitFrameConstants();
+    float time = 0.0f;
+
+    // One program per batch kind, specialized at compile time; their
+    // atlasTexture samplers keep the default texture unit 0
+    ShaderVariants scene;
+    const u32 sceneKeys[] = {SHADER_FEATURE_ALPHA_TEST, SHADER_FEATURE_TEXT};
+    LoadShaderVariants(&scene, "assets/shaders/scene.vert", "assets/shaders/scene.frag", sceneKeys);
+    // Registered again after every reload: an edit can add or drop includes
+    i32 shaderWatch = -1;
+    std::function<void()> watchShaders = [&]
+    {
+        UnwatchAsset(shaderWatch);
+        shaderWatch = WatchAssets(scene.files, [&]
+                                  {
+                                      ReloadShaderVariants(&scene);
+                                      watchShaders();
+                                      RequestRedraw(&pacer); });
+    };
+    watchShaders();
 
     // create one batch
     batches.push_back(Batch{}); // world / scene
@@ -244,35 +81,18 @@ int main()
     auto &ui = batches[1];
     world.reserve(1000); // reserve space for 1000 quads
     ui.reserve(1000);    // reserve space for 1000 quads
-    {
-        // load texture
-        // stbi_set_flip_vertically_on_load(true);
-
-        glGenTextures(1, &world.tex);
-        glBindTexture(GL_TEXTURE_2D, world.tex);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-        unsigned char *data = stbi_load("assets/sprites/sprite.png", &world.w, &world.h, &world.chs, 0);
-        if (data)
-        {
-            GLenum format = GL_RGB;
-            if (world.chs == 4)
-                format = GL_RGBA;
-
-            glTexImage2D(GL_TEXTURE_2D, 0, format, world.w, world.h, 0, format, GL_UNSIGNED_BYTE, data);
-            glGenerateMipmap(GL_TEXTURE_2D);
+    world.shader = SHADER_FEATURE_ALPHA_TEST;
+    ui.shader = SHADER_FEATURE_TEXT;
 
-            ui.w = world.w;
-            ui.h = world.h;
-        }
-        stbi_image_free(data);
-    }
+    // Decoded and uploaded in the background; the placeholder shows until then
+    InitTextures();
+    TextureHandle sprite = LoadTextureAsync("assets/sprites/sprite.png");
 
     {
-        // ui
+        // ui: glyph atlas
+        ui.w = FONT_ATLAS_SIZE;
+        ui.h = FONT_ATLAS_SIZE;
+
         glGenTextures(1, &ui.tex);
         glBindTexture(GL_TEXTURE_2D, ui.tex);
 
@@ -294,6 +114,12 @@ int main()
     }
 
     LoadFont(ui.w, "assets/fonts/arial.ttf");
+    WatchAsset("assets/fonts/arial.ttf", [&]
+               {
+                   // Glyphs are rewritten in place; LoadFont drops the shaped-run cache
+                   glBindTexture(GL_TEXTURE_2D, ui.tex);
+                   LoadFont(ui.w, "assets/fonts/arial.ttf");
+                   RequestRedraw(&pacer); });
     // create VAO, VBO, EBO
     for (auto &b : batches)
     {
@@ -318,29 +144,92 @@ int main()
         glBindVertexArray(0);
     }
 
+    // Simulation runs at a fixed tick rate whatever the frame rate; drawing
+    // interpolates between the last two ticks
+    FixedTimestep simulation;
+    InitFixedTimestep(&simulation);
+    Interpolated<vec2> circle;
+    circle.Reset(vec2(100.0f));
+    vec2 drawnCircle = circle.current;
+
+    bool showMemoryOverlay = false;
     while (!ShouldClose())
     {
+        BeginFrameArena(&frameArena);
+        UpdateFileWatcher();
+        // Headless frames must not depend on decode threads or a wall-clock
+        // budget: every queued texture is on the GPU before drawing
+        if (IsHeadless())
+            FlushTextures();
+        else
+            UpdateTextures();
+
+        // Loads in flight advance once per frame, so don't idle until they land
+        u32 spriteTexture = GetTextureId(sprite);
+        if (spriteTexture != world.tex || TexturesPending())
+            RequestRedraw(&pacer);
+        world.tex = spriteTexture;
+        ivec2 spriteSize = GetTextureSize(sprite);
+        world.w = spriteSize.x;
+        world.h = spriteSize.y;
+
         Event event;
         PollEvent(&event);
+        time += event.deltaTime;
+
+        AdvanceFixedTimestep(&simulation, event.deltaTime, [&](float step)
+                             {
+                                 vec2 move(0.0f);
+                                 if (IsKeyDown(KEY_LEFT)) move.x -= 1.0f;
+                                 if (IsKeyDown(KEY_RIGHT)) move.x += 1.0f;
+                                 if (IsKeyDown(KEY_DOWN)) move.y -= 1.0f;
+                                 if (IsKeyDown(KEY_UP)) move.y += 1.0f;
+                                 circle.Set(circle.current + move * (200.0f * step)); });
+        // Against what is on screen, so the frame where motion stops is drawn
+        vec2 circlePosition = circle.Get(simulation.alpha);
+        if (circlePosition.x != drawnCircle.x || circlePosition.y != drawnCircle.y)
+            RequestRedraw(&pacer);
+
+        if (IsKeyPressed(KEY_F3))
+            showMemoryOverlay = !showMemoryOverlay;
+        if (showMemoryOverlay)
+            RequestRedraw(&pacer); // live counters
+
+        if (!ShouldRender(&pacer, event))
+        {
+            // Still a frame for the per-frame counters and cache aging
+            EndTextFrame();
+            EndMemoryFrame();
+            WaitForNextFrame(&pacer, false);
+            continue;
+        }
 
         // update batch
         DrawRect(vec2(0.0f), vec2(100.0f), ivec2(16, 0), ivec2(16), vec4(1.0f, 0.0f, 1.0f, 1.0f), true, true);
-        DrawCircle(vec2(100.0f), 10.0f);
+        DrawCircle(circlePosition, 10.0f);
+        drawnCircle = circlePosition;
 
         RenderText("Hello, World!", 0, 0, 1.0f, vec4(1.0f));
 
+        if (showMemoryOverlay)
+            DrawMemoryOverlay(8.0f, input->screen.y - 24.0f, 0.35f);
+
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         glViewport(0, 0, input->screen.x, input->screen.y);
 
-        glUseProgram(program);
-        mat4 proj = mat4::Ortho(0, input->screen.x, 0, input->screen.y, -1, 1);
-        SetUniform(program, "projection", proj);
+        FrameConstants frame;
+        frame.projection = mat4::Ortho(0, input->screen.x, 0, input->screen.y, -1, 1);
+        frame.screenSize = vec2(input->screen);
+        frame.time = time;
+        frame.deltaTime = event.deltaTime;
+        SetFrameConstants(frame);
+
         // render a world
         {
             glEnable(GL_DEPTH_TEST);
-            SetUniform(program, "isText", false);
             auto &b = world;
+            glUseProgram(GetShaderVariant(&scene, b.shader)->id);
             glBindVertexArray(b.vao);
             glBindTexture(GL_TEXTURE_2D, b.tex);
 
@@ -361,8 +250,8 @@ int main()
         // render ui
         {
             glDisable(GL_DEPTH_TEST);
-            SetUniform(program, "isText", true);
             auto &b = ui;
+            glUseProgram(GetShaderVariant(&scene, b.shader)->id);
             glBindVertexArray(b.vao);
             glBindTexture(GL_TEXTURE_2D, b.tex);
 
@@ -382,6 +271,9 @@ int main()
         }
 
         SwapBuffersWindow();
+        EndTextFrame();
+        EndMemoryFrame();
+        WaitForNextFrame(&pacer, true);
     }
 
     for (auto &b : batches)
@@ -390,6 +282,12 @@ int main()
         glDeleteBuffers(1, &b.ebo);
         glDeleteVertexArrays(1, &b.vao);
     }
-    glDeleteShader(program);
+    DestroyShaderVariants(&scene);
+    ShutdownFrameConstants();
+    glDeleteTextures(1, &ui.tex);
+    ShutdownTextures();
+    ShutdownFileWatcher();
+    batches.clear();
+    batches.shrink_to_fit();
     DestroyPlatform();
 }
\ No newline at end of file
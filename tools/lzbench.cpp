@@ -0,0 +1,169 @@
+// lzbench: LZ codec ratio and throughput over the asset files.
+//
+//   lzbench [file or directory]...   (defaults to assets/)
+//
+// Images are also measured after decoding, since that is the raw pixel data
+// we would pack or snapshot; the encoded .png/.jpg bytes barely compress.
+#include <engine/lz.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <string.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+#define BENCH_MIN_SECONDS 0.25
+
+struct BenchResult
+{
+    size_t rawSize;
+    size_t packedSize;
+    double compressMBs;
+    double decompressMBs;
+};
+
+static double Now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Repeats `fn` until BENCH_MIN_SECONDS have passed and returns the best MB/s
+template <typename F>
+static double Measure(size_t bytes, F fn)
+{
+    double best = 0.0;
+    double start = Now();
+    do
+    {
+        double t0 = Now();
+        fn();
+        double dt = Now() - t0;
+        if (dt > 0.0)
+            best = std::max(best, bytes / dt / (1024.0 * 1024.0));
+    } while (Now() - start < BENCH_MIN_SECONDS);
+    return best;
+}
+
+static bool Bench(const u8 *data, size_t size, BenchResult *result)
+{
+    std::vector<u8> packed(LzFrameBound(size));
+    std::vector<u8> unpacked(size);
+    size_t packedSize = 0;
+
+    double compress = Measure(size, [&]
+                              { packedSize = LzFrameCompress(data, size, packed.data(), packed.size()); });
+    double decompress = Measure(size, [&]
+                                { LzFrameDecompress(packed.data(), packedSize, unpacked.data(), unpacked.size()); });
+
+    if (!packedSize || memcmp(unpacked.data(), data, size) != 0)
+        return false;
+
+    *result = {size, packedSize, compress, decompress};
+    return true;
+}
+
+static void PrintResult(const std::string &name, const BenchResult &r)
+{
+    printf("%-44s %10zu %10zu %6.1f%% %9.0f %9.0f\n",
+           name.c_str(), r.rawSize, r.packedSize,
+           100.0 * r.packedSize / std::max<size_t>(r.rawSize, 1),
+           r.compressMBs, r.decompressMBs);
+}
+
+static bool ReadWholeFile(const fs::path &path, std::vector<u8> &out)
+{
+    FILE *f = fopen(path.string().c_str(), "rb");
+    if (!f)
+        return false;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    out.resize(size);
+    bool ok = fread(out.data(), 1, size, f) == (size_t)size;
+    fclose(f);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<fs::path> files;
+    std::vector<fs::path> roots;
+    for (int i = 1; i < argc; i++)
+        roots.push_back(argv[i]);
+    if (roots.empty())
+        roots.push_back("assets");
+
+    for (const fs::path &root : roots)
+    {
+        if (fs::is_directory(root))
+        {
+            for (const auto &it : fs::recursive_directory_iterator(root))
+                if (it.is_regular_file())
+                    files.push_back(it.path());
+        }
+        else if (fs::is_regular_file(root))
+        {
+            files.push_back(root);
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    printf("%-44s %10s %10s %7s %9s %9s\n", "file", "raw", "packed", "ratio", "comp MB/s", "dec MB/s");
+
+    BenchResult total = {};
+    double compressTime = 0.0, decompressTime = 0.0;
+    auto accumulate = [&](const BenchResult &r)
+    {
+        total.rawSize += r.rawSize;
+        total.packedSize += r.packedSize;
+        compressTime += r.rawSize / r.compressMBs;
+        decompressTime += r.rawSize / r.decompressMBs;
+    };
+
+    std::vector<u8> data;
+    for (const fs::path &file : files)
+    {
+        if (!ReadWholeFile(file, data) || data.empty())
+            continue;
+
+        std::string name = file.generic_string();
+        BenchResult r;
+        if (!Bench(data.data(), data.size(), &r))
+        {
+            printf("%-44s round trip FAILED\n", name.c_str());
+            return 1;
+        }
+        PrintResult(name, r);
+        accumulate(r);
+
+        int w, h, channels;
+        u8 *pixels = stbi_load_from_memory(data.data(), (int)data.size(), &w, &h, &channels, 4);
+        if (pixels)
+        {
+            if (!Bench(pixels, (size_t)w * h * 4, &r))
+            {
+                printf("%-44s round trip FAILED\n", (name + " (rgba)").c_str());
+                return 1;
+            }
+            PrintResult(name + " (rgba)", r);
+            accumulate(r);
+            stbi_image_free(pixels);
+        }
+    }
+
+    if (total.rawSize)
+    {
+        total.compressMBs = total.rawSize / compressTime;
+        total.decompressMBs = total.rawSize / decompressTime;
+        PrintResult("total", total);
+    }
+    return 0;
+}
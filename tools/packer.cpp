@@ -0,0 +1,177 @@
+// packer: builds an asset pack from files and directories.
+//
+//   packer [-c] <output.pak> <file or directory>...
+//
+//   -c  LZ-compress entries that shrink by at least 1/8
+//
+// Paths are stored as given on the command line (relative to the working
+// directory, '/' separators), so "assets/shaders/scene.vert" in the pack
+// matches the path the engine asks for.
+#include <engine/pack.h>
+#include <engine/lz.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <string.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct PackInput
+{
+    std::string path;   // normalized path stored in the pack
+    fs::path source;
+    PackEntry entry;
+};
+
+static std::string NormalizePath(const fs::path &path)
+{
+    std::string s = path.lexically_normal().generic_string();
+    if (s.rfind("./", 0) == 0)
+        s.erase(0, 2);
+    return s;
+}
+
+static bool ReadWholeFile(const fs::path &path, std::vector<u8> &out)
+{
+    FILE *f = fopen(path.string().c_str(), "rb");
+    if (!f)
+        return false;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    out.resize(size);
+    bool ok = fread(out.data(), 1, size, f) == (size_t)size;
+    fclose(f);
+    return ok;
+}
+
+static void WritePadding(FILE *f, u64 &offset, u64 alignment)
+{
+    static const u8 zeros[PACK_ALIGNMENT] = {};
+    u64 aligned = (offset + alignment - 1) & ~(alignment - 1);
+    fwrite(zeros, 1, aligned - offset, f);
+    offset = aligned;
+}
+
+int main(int argc, char **argv)
+{
+    bool compress = argc > 1 && strcmp(argv[1], "-c") == 0;
+    if (compress)
+    {
+        argv++;
+        argc--;
+    }
+
+    if (argc < 3)
+    {
+        printf("usage: packer [-c] <output.pak> <file or directory>...\n");
+        return 1;
+    }
+
+    std::vector<PackInput> inputs;
+    for (int i = 2; i < argc; i++)
+    {
+        fs::path root = argv[i];
+        if (fs::is_directory(root))
+        {
+            for (const auto &it : fs::recursive_directory_iterator(root))
+            {
+                if (it.is_regular_file())
+                    inputs.push_back(PackInput{NormalizePath(it.path()), it.path(), {}});
+            }
+        }
+        else if (fs::is_regular_file(root))
+        {
+            inputs.push_back(PackInput{NormalizePath(root), root, {}});
+        }
+        else
+        {
+            printf("packer: skipping %s (not found)\n", argv[i]);
+        }
+    }
+
+    for (PackInput &input : inputs)
+        input.entry.pathHash = HashString(input.path);
+
+    std::sort(inputs.begin(), inputs.end(), [](const PackInput &a, const PackInput &b)
+              { return a.entry.pathHash != b.entry.pathHash ? a.entry.pathHash < b.entry.pathHash : a.path < b.path; });
+
+    FILE *out = fopen(argv[1], "wb");
+    if (!out)
+    {
+        printf("packer: cannot open %s for writing\n", argv[1]);
+        return 1;
+    }
+
+    PackHeader header = {};
+    header.magic = PACK_MAGIC;
+    header.version = PACK_VERSION;
+    header.entryCount = (u32)inputs.size();
+    fwrite(&header, sizeof(header), 1, out);
+    u64 offset = sizeof(header);
+
+    std::string strings;
+    std::vector<u8> data;
+    std::vector<u8> packed;
+    u64 rawTotal = 0;
+    for (PackInput &input : inputs)
+    {
+        if (!ReadWholeFile(input.source, data))
+        {
+            printf("packer: failed to read %s\n", input.path.c_str());
+            fclose(out);
+            return 1;
+        }
+
+        WritePadding(out, offset, PACK_ALIGNMENT);
+
+        PackEntry &entry = input.entry;
+        entry.offset = offset;
+        entry.rawSize = data.size();
+        entry.compression = PACK_COMPRESSION_NONE;
+        entry.pathOffset = (u32)strings.size();
+        strings.append(input.path);
+        strings.push_back('\0');
+
+        const std::vector<u8> *stored = &data;
+        if (compress && !data.empty())
+        {
+            packed.resize(LzFrameBound(data.size()));
+            size_t size = LzFrameCompress(data.data(), data.size(), packed.data(), packed.size());
+            if (size && size <= data.size() - data.size() / 8)
+            {
+                packed.resize(size);
+                stored = &packed;
+                entry.compression = PACK_COMPRESSION_LZ;
+            }
+        }
+
+        entry.size = stored->size();
+        fwrite(stored->data(), 1, stored->size(), out);
+        offset += stored->size();
+        rawTotal += data.size();
+    }
+
+    WritePadding(out, offset, alignof(PackEntry));
+    header.tocOffset = offset;
+    for (const PackInput &input : inputs)
+        fwrite(&input.entry, sizeof(PackEntry), 1, out);
+    offset += inputs.size() * sizeof(PackEntry);
+
+    header.stringsOffset = offset;
+    header.stringsSize = strings.size();
+    fwrite(strings.data(), 1, strings.size(), out);
+    offset += strings.size();
+
+    fseek(out, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, out);
+    fclose(out);
+
+    printf("packer: %zu files, %llu bytes -> %s (%llu bytes)\n",
+           inputs.size(), (unsigned long long)rawTotal, argv[1], (unsigned long long)offset);
+    return 0;
+}
@@ -0,0 +1,187 @@
+// texcook: converts source images into cooked .ctex textures.
+//
+//   texcook [-bc] -o <output dir> <file or directory>...
+//
+//   -bc  block-compress: BC1 when alpha is only 0/255, BC3 otherwise
+//
+// "assets/sprites/sprite.png" is written to "<output dir>/assets/sprites/sprite.ctex",
+// so mounting the output directory in the VFS puts the cooked file next to
+// its source, where the texture loader looks for it. Up-to-date outputs are
+// skipped.
+#include <engine/image.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+#include <filesystem>
+#include <string>
+#include <string.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static bool IsImage(const fs::path &path)
+{
+    std::string ext = path.extension().string();
+    for (char &c : ext)
+        c = (char)tolower(c);
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" || ext == ".bmp";
+}
+
+static std::string NormalizePath(const fs::path &path)
+{
+    std::string s = path.lexically_normal().generic_string();
+    if (s.rfind("./", 0) == 0)
+        s.erase(0, 2);
+    return s;
+}
+
+static size_t AlignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static bool Cook(const fs::path &source, const fs::path &output, bool blockCompress, size_t *cookedSize)
+{
+    int width, height, channels;
+    u8 *pixels = stbi_load(source.string().c_str(), &width, &height, &channels, 4);
+    if (!pixels)
+    {
+        printf("texcook: cannot decode %s\n", source.string().c_str());
+        return false;
+    }
+
+    size_t pixelCount = (size_t)width * height;
+    bool binaryAlpha = true;
+    for (size_t i = 0; i < pixelCount && binaryAlpha; i++)
+        binaryAlpha = pixels[i * 4 + 3] == 0 || pixels[i * 4 + 3] == 255;
+
+    PremultiplyAlpha(pixels, pixelCount);
+
+    CtexHeader header = {};
+    header.magic = CTEX_MAGIC;
+    header.version = CTEX_VERSION;
+    header.format = !blockCompress ? CTEX_FORMAT_RGBA8 : binaryAlpha ? CTEX_FORMAT_BC1 : CTEX_FORMAT_BC3;
+    header.flags = CTEX_FLAG_PREMULTIPLIED;
+    header.width = width;
+    header.height = height;
+    header.levelCount = MipLevelCount(width, height);
+
+    // Mip chain in RGBA8 first; block compression runs per level afterwards
+    std::vector<std::vector<u8>> levels(header.levelCount);
+    levels[0].assign(pixels, pixels + pixelCount * 4);
+    stbi_image_free(pixels);
+    for (u32 level = 1; level < header.levelCount; level++)
+    {
+        levels[level].resize((size_t)MipSize(width, level) * MipSize(height, level) * 4);
+        DownsampleRGBA8(levels[level - 1].data(), MipSize(width, level - 1), MipSize(height, level - 1), levels[level].data());
+    }
+
+    u32 blockBytes = CtexBlockBytes(header.format);
+    if (blockBytes)
+    {
+        for (u32 level = 0; level < header.levelCount; level++)
+        {
+            i32 w = MipSize(width, level);
+            i32 h = MipSize(height, level);
+            std::vector<u8> encoded(BlockCompressedSize(w, h, blockBytes));
+            if (header.format == CTEX_FORMAT_BC1)
+                EncodeBC1(levels[level].data(), w, h, encoded.data());
+            else
+                EncodeBC3(levels[level].data(), w, h, encoded.data());
+            levels[level] = std::move(encoded);
+        }
+    }
+
+    size_t offset = AlignUp(sizeof(CtexHeader), CTEX_ALIGNMENT);
+    for (u32 level = 0; level < header.levelCount; level++)
+    {
+        header.levels[level].offset = offset;
+        header.levels[level].size = levels[level].size();
+        offset = AlignUp(offset + levels[level].size(), CTEX_ALIGNMENT);
+    }
+
+    fs::create_directories(output.parent_path());
+    FILE *f = fopen(output.string().c_str(), "wb");
+    if (!f)
+    {
+        printf("texcook: cannot open %s for writing\n", output.string().c_str());
+        return false;
+    }
+
+    static const u8 zeros[CTEX_ALIGNMENT] = {};
+    size_t written = fwrite(&header, 1, sizeof(header), f);
+    for (u32 level = 0; level < header.levelCount; level++)
+    {
+        written += fwrite(zeros, 1, header.levels[level].offset - written, f);
+        written += fwrite(levels[level].data(), 1, levels[level].size(), f);
+    }
+    fclose(f);
+
+    *cookedSize = written;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    bool blockCompress = false;
+    fs::path outputDir;
+    std::vector<fs::path> roots;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-bc") == 0)
+            blockCompress = true;
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            outputDir = argv[++i];
+        else
+            roots.push_back(argv[i]);
+    }
+
+    if (outputDir.empty() || roots.empty())
+    {
+        printf("usage: texcook [-bc] -o <output dir> <file or directory>...\n");
+        return 1;
+    }
+
+    std::vector<fs::path> sources;
+    for (const fs::path &root : roots)
+    {
+        if (fs::is_directory(root))
+        {
+            for (const auto &it : fs::recursive_directory_iterator(root))
+                if (it.is_regular_file() && IsImage(it.path()))
+                    sources.push_back(it.path());
+        }
+        else if (fs::is_regular_file(root))
+        {
+            sources.push_back(root);
+        }
+        else
+        {
+            printf("texcook: skipping %s (not found)\n", root.string().c_str());
+        }
+    }
+
+    u32 cooked = 0, skipped = 0;
+    for (const fs::path &source : sources)
+    {
+        fs::path output = outputDir / fs::path(NormalizePath(source)).replace_extension(".ctex");
+
+        std::error_code error;
+        if (fs::exists(output, error) && fs::last_write_time(output, error) >= fs::last_write_time(source, error))
+        {
+            skipped++;
+            continue;
+        }
+
+        size_t size = 0;
+        if (!Cook(source, output, blockCompress, &size))
+            return 1;
+
+        printf("texcook: %s -> %s (%zu bytes)\n", source.string().c_str(), output.string().c_str(), size);
+        cooked++;
+    }
+
+    printf("texcook: %u cooked, %u up to date\n", cooked, skipped);
+    return 0;
+}